@@ -0,0 +1,217 @@
+//===----------------------------------------------------------===//
+// Alg module
+//
+// File purpose: ~deltaSelector~ class implementation. See header
+// file for more detail
+//===----------------------------------------------------------===//
+
+#include "Alg/deltaSelector.hpp"
+#include "Utils/error.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace Alg {
+
+using graphT = DS::csrGraph;
+// Wide enough for the paths of any graph (see ~needsWideDists~)
+typedef uint64_t distT;
+
+constexpr const char* deltaSelector::kstatisticsArg;
+constexpr const char* deltaSelector::ksampledArg;
+
+deltaSelector::deltaSelector(const graphT& graph, const nodeIdT sourceNode,
+                             const unsigned numThreads)
+  : graph(graph), sourceNode(sourceNode), numThreads(numThreads)
+{}
+
+deltaSelector::mode deltaSelector::parseMode(const char* arg)
+{
+  if (strcmp(arg, kstatisticsArg) == 0) {
+    return mode::statistics;
+  }
+  if (strcmp(arg, ksampledArg) == 0) {
+    return mode::sampled;
+  }
+  return mode::fixed;
+}
+
+deltaSelector::choice deltaSelector::select(const mode selectMode)
+  noexcept(false)
+{
+  switch (selectMode) {
+    case mode::statistics:
+      return fromStatistics();
+    case mode::sampled:
+      return refine(fromStatistics());
+    default:
+      throw invalid_argument{"(deltaSelector) no automatic mode given"};
+  }
+}
+
+deltaSelector::choice deltaSelector::fromStatistics() const
+{
+  LOG(ALG_DELTASTEPPING_DEBUG, "Start -- deltaSelector::fromStatistics");
+  const unsigned numNonSinks = countNonSinks();
+  if (graph.getNumEdges() == 0 || numNonSinks == 0) {
+    return choice{1.0, "the graph has no edges"};
+  }
+  const double avgDegree =
+    static_cast<double>(graph.getNumEdges()) / numNonSinks;
+  const double q = min(1.0, klightPerNode / avgDegree);
+  const weightT quantile = weightQuantile(q);
+  const float delta = max(1.0f, static_cast<float>(quantile));
+
+  ostringstream reason;
+  reason << setprecision(3) << "weight quantile " << q
+         << " (average degree " << avgDegree << ", max weight "
+         << graph.getMaxEdgeWeight() << ')';
+  LOG(ALG_DELTASTEPPING_DEBUG, "End -- deltaSelector::fromStatistics");
+  return choice{delta, reason.str()};
+}
+
+// Deltas are powers of two apart, so that the cost of the estimate
+// is compared to the ones of clearly different choices. On small
+// graphs, the sample is the whole run.
+deltaSelector::choice deltaSelector::refine(const choice& estimate) const
+{
+  LOG(ALG_DELTASTEPPING_DEBUG, "Start -- deltaSelector::refine");
+  unsigned estimateSettled = 0;
+  const double estimateCost = sampleCost(estimate.delta, estimateSettled);
+  if (estimateSettled < kminSampledNodes) {
+    return choice{estimate.delta, estimate.reason +
+                    "; too few nodes reachable to refine it"};
+  }
+  float bestDelta = estimate.delta;
+  double bestCost = estimateCost;
+  unsigned numCandidates = 1;
+  for (int i = -kcandidateSteps; i <= kcandidateSteps; ++i) {
+    const float candidate = estimate.delta * ldexp(1.0f, i);
+    if (i == 0 || candidate < 1.0f) {
+      continue;
+    }
+    unsigned settled = 0;
+    const double cost = sampleCost(candidate, settled);
+    ++numCandidates;
+    if (cost < bestCost) {
+      bestCost = cost;
+      bestDelta = candidate;
+    }
+  }
+
+  ostringstream reason;
+  reason << setprecision(3) << "refined from " << estimate.delta << " ("
+         << estimate.reason << ") by running " << numCandidates
+         << " deltas for " << estimateSettled << " nodes; work per node "
+         << bestCost << " against " << estimateCost;
+  LOG(ALG_DELTASTEPPING_DEBUG, "End -- deltaSelector::refine");
+  return choice{bestDelta, reason.str()};
+}
+
+// A sequential run in the manner of ~deltaStepping::original~, that
+// stops at the first bucket boundary after ~ksampledNodes~ nodes got
+// settled. Buckets live in a map, as only a few of them are ever
+// filled here.
+double deltaSelector::sampleCost(const float delta, unsigned& settled) const
+{
+  const distT infDist = numeric_limits<distT>::max();
+  vector<distT> dists(graph.getNumNodes(), infDist);
+  vector<bool> isSettled(graph.getNumNodes(), false);
+  map<distT, buckT> bucks;
+  double numRelaxed = 0.0;
+  double numPhases = 0.0;
+
+  auto relax = [&](const edgeIdT begin, const edgeIdT end,
+                   const distT srcDist) {
+    for (edgeIdT e = begin; e < end; ++e) {
+      const nodeIdT destNodeId = graph.target(e);
+      const distT newDist = srcDist + graph.weight(e);
+      ++numRelaxed;
+      if (newDist < dists[destNodeId]) {
+        dists[destNodeId] = newDist;
+        bucks[static_cast<distT>(newDist / delta)].push_back(destNodeId);
+      }
+    }
+  };
+
+  settled = 0;
+  dists[sourceNode] = 0;
+  bucks[0].push_back(sourceNode);
+  while (!bucks.empty() && settled < ksampledNodes) {
+    const distT buckIdx = bucks.begin()->first;
+    buckT rm;
+    while (bucks.count(buckIdx) != 0) {
+      buckT curBuck;
+      curBuck.swap(bucks[buckIdx]);
+      bucks.erase(buckIdx);
+      ++numPhases;
+      for (auto srcNodeId : curBuck) {
+        rm.push_back(srcNodeId);
+        relax(graph.outBegin(srcNodeId), lightEnd(srcNodeId, delta),
+              dists[srcNodeId]);
+      }
+    }
+    ++numPhases;
+    for (auto srcNodeId : rm) {
+      relax(lightEnd(srcNodeId, delta), graph.outEnd(srcNodeId),
+            dists[srcNodeId]);
+      if (!isSettled[srcNodeId]) {
+        isSettled[srcNodeId] = true;
+        ++settled;
+      }
+    }
+  }
+  LOG(ALG_DELTASTEPPING_DEBUG, "delta %f: %u nodes, %.0f edges, %.0f phases",
+      delta, settled, numRelaxed, numPhases);
+  return (numRelaxed / numThreads + numPhases * kphaseCost) /
+    max(settled, 1u);
+}
+
+// The graph may be split for another delta, so the split is found
+// here without touching it.
+inline
+edgeIdT deltaSelector::lightEnd(const nodeIdT nodeId, const float delta) const
+{
+  return graph.upperBound(nodeId, static_cast<weightT>(delta));
+}
+
+// Nodes without outgoing edges are left out of the average degree,
+// as node IDs may have gaps.
+unsigned deltaSelector::countNonSinks() const
+{
+  const unsigned numNodes = graph.getNumNodes();
+  unsigned numNonSinks = 0;
+  #pragma omp parallel for num_threads(numThreads) reduction(+:numNonSinks)
+  for (unsigned i = 0; i < numNodes; ++i) {
+    if (graph.outDegree(i) != 0) {
+      ++numNonSinks;
+    }
+  }
+  return numNonSinks;
+}
+
+// Edges are sampled at a fixed stride over the whole weight array.
+weightT deltaSelector::weightQuantile(const double q) const
+{
+  const edgeIdT numEdges = graph.getNumEdges();
+  const edgeIdT stride = max<edgeIdT>(1, numEdges / ksampledEdges);
+  vector<weightT> sample;
+  for (edgeIdT e = 0; e < numEdges; e += stride) {
+    sample.push_back(graph.weight(e));
+  }
+  const size_t pos = min(sample.size() - 1,
+                         static_cast<size_t>(q * sample.size()));
+  nth_element(sample.begin(), sample.begin() + pos, sample.end());
+  return sample[pos];
+}
+
+}
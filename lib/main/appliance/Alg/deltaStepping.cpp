@@ -1,14 +1,16 @@
 //===----------------------------------------------------------===//
 // Alg module
 //
-// File purpose: ~deltaStepping~ class implementation. See header
+// File purpose: ~basicDeltaStepping~ class implementation. See header
 // file for more detail
 //===----------------------------------------------------------===//
 
 #include "Alg/deltaStepping.hpp"
+#include "Utils/atomicOps.hpp"
 #include "Utils/num.hpp"
 #include "Utils/str.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cmath>
@@ -19,34 +21,157 @@
 using namespace std;
 using namespace Utils;
 
-// typedef chrono::duration<double> clkT;
-// clkT part1Temp = clkT::zero();
-// clkT part1Sum = clkT::zero();
-// clkT part2Temp = clkT::zero();
-// clkT part2Sum = clkT::zero();
-// clkT part3Temp = clkT::zero();
-// clkT part3Sum = clkT::zero();
-
 namespace Alg {
 
-using digraph = DS::digraph<nodeIdT>;
+using graphT = DS::csrGraph;
+
+template <typename distT>
+constexpr nodeIdT basicDeltaStepping<distT>::knoTarget;
+template <typename distT>
+constexpr nodeIdT basicDeltaStepping<distT>::knoPred;
+template <typename distT>
+constexpr uint64_t basicDeltaStepping<distT>::kunreachedDist;
+template <typename distT>
+constexpr unsigned basicDeltaStepping<distT>::kfullResetDivisor;
+template <typename distT>
+constexpr bool basicDeltaStepping<distT>::kisPackable;
+template <typename distT>
+constexpr unsigned basicDeltaStepping<distT>::kpathLocks;
+template <typename distT>
+constexpr unsigned basicDeltaStepping<distT>::kmaxWindowBucks;
+template <typename distT>
+constexpr unsigned basicDeltaStepping<distT>::kdenseDivisor;
+template <typename distT>
+constexpr unsigned basicDeltaStepping<distT>::kdenseChunkWords;
+
+typedef std::chrono::steady_clock statsClockT;
+
+// Only used on distances that fit, see ~kisPackable~.
+template <typename distT>
+static inline distPredT packDistPred(const distT dist, const nodeIdT pred)
+{
+  return (static_cast<distPredT>(dist) << 32) | pred;
+}
+
+template <typename distT>
+static inline distT unpackDist(const distPredT distPred)
+{
+  return static_cast<distT>(distPred >> 32);
+}
 
-// Static members
-float deltaStepping::delta = 0.0;
+static inline nodeIdT unpackPred(const distPredT distPred)
+{
+  return static_cast<nodeIdT>(distPred);
+}
 
-deltaStepping::deltaStepping()
-  : sourceNode(0),
+template <typename distT>
+basicDeltaStepping<distT>::basicDeltaStepping()
+  : graph(nullptr),
+    delta(0.0),
+    sourceNode(0),
+    targetNode(knoTarget),
+    isTrackingPaths(false),
+    order(nullptr),
+    isPacked(false),
+    simdFilter(nullptr),
+    minBuckNum(0),
+    overflowMinBuck(std::numeric_limits<buckNumT>::max()),
     kminBuckThreshold(1000),
-    locks(nullptr)
+    isDenseFrontier(false),
+    denseSrc(nullptr),
+    denseSrcSz(0),
+    numReserved(0),
+    gOverflowSz(0),
+    reverseOf(nullptr)
 {}
 
 
-distsT& deltaStepping::getDists()
+template <typename distT>
+const typename basicDeltaStepping<distT>::distsT&
+basicDeltaStepping<distT>::getDists() const
 {
-  return dists;
+  return order == nullptr ? dists : outDists;
 }    
 
-void deltaStepping::printOutToFile(const char* outFileName)
+template <typename distT>
+nodeIdT basicDeltaStepping<distT>::getSourceNode() const
+{
+  return order == nullptr ? sourceNode : order->toOld(sourceNode);
+}
+
+template <typename distT>
+nodeIdT basicDeltaStepping<distT>::getTargetNode() const
+{
+  if (order == nullptr || targetNode == knoTarget) {
+    return targetNode;
+  }
+  return order->toOld(targetNode);
+}
+
+template <typename distT>
+void basicDeltaStepping<distT>::setNodeOrder(const nodeOrder* order)
+{
+  this->order = order;
+}
+
+template <typename distT>
+void basicDeltaStepping<distT>::setIsTrackingPaths(const bool isTrackingPaths)
+{
+  this->isTrackingPaths = isTrackingPaths;
+}
+
+template <typename distT>
+bool basicDeltaStepping<distT>::getIsTrackingPaths() const
+{
+  return isTrackingPaths;
+}
+
+template <typename distT>
+const predsT& basicDeltaStepping<distT>::getPreds() const noexcept(false)
+{
+  const predsT& allPreds = order == nullptr ? preds : outPreds;
+  if (allPreds.size() != getDists().size()) {
+    throw std::logic_error{"(getPreds) paths were not tracked"};
+  }
+  return allPreds;
+}
+
+// A path never has more nodes than the graph, so a longer walk means
+// the predecessors are broken, rather than looping forever.
+template <typename distT>
+std::vector<nodeIdT>
+basicDeltaStepping<distT>::getPath(const nodeIdT nodeId) const
+  noexcept(false)
+{
+  const predsT& allPreds = getPreds();
+  const distsT& allDists = getDists();
+  std::vector<nodeIdT> path;
+  if (nodeId >= allDists.size() || allDists[nodeId] == infDist) {
+    return path;
+  }
+  for (nodeIdT cur = nodeId; cur != knoPred; cur = allPreds[cur]) {
+    if (path.size() == allDists.size()) {
+      throw std::logic_error{string("(getPath) no path to node ") +
+			       to_string(nodeId)};
+    }
+    path.push_back(cur);
+  }
+  if (path.back() != getSourceNode()) {
+    throw std::logic_error{string("(getPath) no path to node ") +
+			     to_string(nodeId)};
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+template <typename distT>
+const runStats& basicDeltaStepping<distT>::getStats() const
+{
+  return stats;
+}
+
+template <typename distT>
+void basicDeltaStepping<distT>::printOutToFile(const char* outFileName)
 {
   if (outFile.is_open()) {
     outFile.close();
@@ -56,73 +181,160 @@ void deltaStepping::printOutToFile(const char* outFileName)
   outFile.close();
 }
 
-void deltaStepping::printOutToStream(std::ostream& os)
+// With paths, the target's path is written on a comment line after
+// its distance, and full runs get the predecessor of every node as a
+// third column.
+template <typename distT>
+void basicDeltaStepping<distT>::printOutToStream(std::ostream& os)
 {
-  for (unsigned i = 0; i < dists.size(); ++i) {
-    os << i << ' ' << dists.at(i) << '\n';
+  const distsT& allDists = getDists();
+  const nodeIdT outTarget = getTargetNode();
+  if (outTarget != knoTarget) {
+    os << outTarget << ' ' << toOutDist(allDists.at(outTarget)) << '\n';
+    if (isTrackingPaths) {
+      os << "% path";
+      for (auto nodeId : getPath(outTarget)) {
+	os << ' ' << nodeId;
+      }
+      os << '\n';
+    }
+    return;
+  }
+  if (isTrackingPaths) {
+    const predsT& allPreds = getPreds();
+    for (unsigned i = 0; i < allDists.size(); ++i) {
+      os << i << ' ' << toOutDist(allDists.at(i)) << ' ' << allPreds.at(i)
+	 << '\n';
+    }
+    return;
+  }
+  for (unsigned i = 0; i < allDists.size(); ++i) {
+    os << i << ' ' << toOutDist(allDists.at(i)) << '\n';
   }  
 }
   
-deltaStepping::~deltaStepping()
+template <typename distT>
+basicDeltaStepping<distT>::~basicDeltaStepping()
 {}
   
-void deltaStepping::run(digraph* inGraph, const char* mode, 
-			const float delta, const unsigned numThreads)
+template <typename distT>
+void basicDeltaStepping<distT>::run(graphT* inGraph, const char* mode,
+				    const float delta,
+				    const unsigned numThreads,
+				    const nodeIdT sourceNode,
+				    const nodeIdT targetNode)
+{
+  bind(inGraph, mode, delta, numThreads);
+  solve(sourceNode, targetNode);
+}
+
+// The distances are sized here, and left all infinite, so that the
+// first run has nothing to reset either.
+template <typename distT>
+void basicDeltaStepping<distT>::bind(graphT* inGraph, const char* mode,
+				     const float delta,
+				     const unsigned numThreads)
+  noexcept(false)
+{
+  if (delta < 1.0) {
+    throw std::logic_error{string("Invalid delta '") +
+			     to_string(delta) + "'"};
+  }
+  if (numThreads < 1) {
+    throw std::logic_error{string("Invalid number of threads '") +
+			     to_string(numThreads) + "'"};
+  }
+  assignGraph(inGraph);
+  if (order != nullptr && order->size() != graph->getNumNodes()) {
+    throw std::logic_error{"(bind) the node order is not of this graph"};
+  }
+  this->delta = delta;
+  this->numThreads = numThreads;
+  this->mode = mode;
+  parts = graph->partition(numThreads);
+  prepareGraph(graph, delta, numThreads);
+  resetDists(dists, preds, touched);
+}
+
+template <typename distT>
+void basicDeltaStepping<distT>::solve(const nodeIdT sourceNode,
+				      const nodeIdT targetNode)
+  noexcept(false)
 {
-  initInternalVars(inGraph, mode, delta, numThreads);
+  if (graph == nullptr) {
+    throw std::logic_error{"(solve) no graph was bound"};
+  }
+  if (sourceNode >= graph->getNumNodes()) {
+    throw std::invalid_argument{string("Invalid source node '") +
+				  to_string(sourceNode) + "'"};
+  }
+  this->sourceNode = order == nullptr ? sourceNode : order->toNew(sourceNode);
+  if (targetNode != knoTarget && targetNode >= graph->getNumNodes()) {
+    throw std::invalid_argument{string("Invalid target node '") +
+				  to_string(targetNode) + "'"};
+  }
+  this->targetNode = order == nullptr || targetNode == knoTarget
+    ? targetNode : order->toNew(targetNode);
+  initStats();
 
-  const string modeStr{mode};
-  if (modeStr == "original")
+  if (mode == "original")
     original();
-  else if (modeStr == "parallel") {
+  else if (mode == "parallel") {
     if (ALG_DELTASTEPPING_ASSERT) {
-      assertEqualRes(&deltaStepping::parallel,
-		     &deltaStepping::dijkstra);
+      assertEqualRes(&basicDeltaStepping::parallel,
+		     &basicDeltaStepping::dijkstra);
     }
     else {
       parallel();
     }
   }
-  else if (modeStr == "parallel-bucket-fusion") {
+  else if (mode == "parallel-bucket-fusion") {
     if (ALG_DELTASTEPPING_ASSERT) {
-      assertEqualRes(&deltaStepping::parallelBucketFusion,
-		     &deltaStepping::dijkstra);
+      assertEqualRes(&basicDeltaStepping::parallelBucketFusion,
+		     &basicDeltaStepping::dijkstra);
     }
     else {
       parallelBucketFusion();
     }      
   }
-  else if (modeStr == "dijkstra")
+  else if (mode == "dijkstra")
     dijkstra();
+  else if (mode == "radix-dijkstra") {
+    if (ALG_DELTASTEPPING_ASSERT) {
+      assertEqualRes(&basicDeltaStepping::radixDijkstra,
+		     &basicDeltaStepping::dijkstra);
+    }
+    else {
+      radixDijkstra();
+    }
+  }
+  else if (mode == "bidirectional-dijkstra")
+    bidirectionalDijkstra();
   else
-    invalidMode(mode);
+    invalidMode(mode.c_str());
+  if (order != nullptr) {
+    mapBack();
+  }
 }
 
-void deltaStepping::initInternalVars(digraph* inGraph, const char* mode,
-				     const float delta,
-				     const unsigned numThreads)
+// Edge weights are integers, so w <= delta is w <= floor(delta).
+template <typename distT>
+void basicDeltaStepping<distT>::prepareGraph(graphT* graph, const float delta,
+					     const unsigned numThreads)
 {
-  if (delta < 1.0) {
-    throw std::logic_error{string("Invalid delta '") +
-			     to_string(delta) + "'"};
-  }
-  this->delta = delta;
-  if (numThreads < 1) {
-    throw std::logic_error{string("Invalid number of threads '") +
-			     to_string(numThreads) + "'"};
-  }
-  this->numThreads = numThreads;
-  assignGraph(inGraph);
+  graph->splitLightHeavy(static_cast<weightT>(delta), numThreads);
 }
 
-void deltaStepping::assignGraph(digraph* inGraph) {
+template <typename distT>
+void basicDeltaStepping<distT>::assignGraph(graphT* inGraph) {
   if (inGraph == nullptr) {
     throw invalid_argument{"(assignGraph) nullptr inGraph argument"};
   }
-  diGraph = inGraph;
+  graph = inGraph;
 }
 
-void deltaStepping::invalidMode(const char* mode)
+template <typename distT>
+void basicDeltaStepping<distT>::invalidMode(const char* mode)
 {
   throw invalid_argument{
     string("Unknown option '") + mode + "' for the deltaStepping algorithm"};
@@ -132,49 +344,159 @@ void deltaStepping::invalidMode(const char* mode)
 // Below is the implementation of the main algorithms
 //===----------------------------------------------------------===//
 
-typedef std::pair<nodeIdT, distT> dijkstraPair; 
+template <typename distT>
+using dijkstraPair = std::pair<nodeIdT, distT>;
+template <typename distT>
 class ordDijkstra {
 public:
-  bool operator() (const dijkstraPair& a, const dijkstraPair& b) {
+  bool operator() (const dijkstraPair<distT>& a,
+		   const dijkstraPair<distT>& b) {
     return a.second > b.second;
   }
 };
-void deltaStepping::dijkstra()
+template <typename distT>
+void basicDeltaStepping<distT>::dijkstra()
 {
-  std::priority_queue<dijkstraPair, std::vector<dijkstraPair>,
-		      ordDijkstra> frontier;
-  std::vector<bool> isVisited(diGraph->getNumNodes(), false);
-  dists.resize(diGraph->getNumNodes(), infDist);
+  std::priority_queue<dijkstraPair<distT>, std::vector<dijkstraPair<distT> >,
+		      ordDijkstra<distT> > frontier;
+  std::vector<bool> isVisited(graph->getNumNodes(), false);
+  resetDists(dists, preds, touched);
   dists.at(sourceNode) = 0;
+  touched.push_back(sourceNode);
   frontier.push(make_pair(sourceNode, dists.at(sourceNode)));
   while (!frontier.empty()) {
     nodeIdT srcNodeId = frontier.top().first;
     frontier.pop();
+    if (srcNodeId == targetNode) {
+      break;
+    }
     isVisited.at(srcNodeId) = true;
-    auto* srcNode = diGraph->at(srcNodeId);
-    auto* edges = srcNode->getOutEdges();
-    if (edges != nullptr) {
-      for (unsigned i = 0; i < edges->size(); ++i) {
-	auto& edge = edges->at(i);
-	auto& destNodeId = edge.first;
-	auto& edgeWeight = edge.second;
-	distT& oldDist = dists.at(destNodeId);
-	distT newDist = dists.at(srcNodeId) + edgeWeight;
-	if (newDist < oldDist) {
-	  dists.at(destNodeId) = newDist;
-	  if (!isVisited.at(destNodeId)) {
-	    frontier.push(make_pair(destNodeId, dists.at(destNodeId)));
-	  }
+    graph->forEdges(graph->outBegin(srcNodeId), graph->outEnd(srcNodeId),
+		    [&](const nodeIdT destNodeId, const weightT edgeWeight) {
+      distT& oldDist = dists.at(destNodeId);
+      distT newDist = dists.at(srcNodeId) + edgeWeight;
+      if (newDist < oldDist) {
+	if (oldDist == infDist) {
+	  touched.push_back(destNodeId);
+	}
+	dists.at(destNodeId) = newDist;
+	if (isTrackingPaths) {
+	  preds[destNodeId] = srcNodeId;
+	}
+	if (!isVisited.at(destNodeId)) {
+	  frontier.push(make_pair(destNodeId, dists.at(destNodeId)));
 	}
       }
-    }    
+    });
   }
 }  
 
+// Weights are unsigned integers, so the keys popped never decrease,
+// which is all a radix heap asks for. A node may be in the heap many
+// times; only the entry with its current distance is expanded.
+template <typename distT>
+void basicDeltaStepping<distT>::radixDijkstra()
+{
+  DS::radixHeap<distT, nodeIdT> frontier;
+  resetDists(dists, preds, touched);
+  dists[sourceNode] = 0;
+  touched.push_back(sourceNode);
+  frontier.push(0, sourceNode);
+  while (!frontier.empty()) {
+    const auto top = frontier.pop();
+    const distT srcDist = top.first;
+    const nodeIdT srcNodeId = top.second;
+    if (srcDist != dists[srcNodeId]) {
+      continue;
+    }
+    if (srcNodeId == targetNode) {
+      break;
+    }
+    graph->forEdges(graph->outBegin(srcNodeId), graph->outEnd(srcNodeId),
+		    [&](const nodeIdT destNodeId, const weightT edgeWeight) {
+      const distT newDist = srcDist + edgeWeight;
+      if (newDist < dists[destNodeId]) {
+	if (dists[destNodeId] == infDist) {
+	  touched.push_back(destNodeId);
+	}
+	dists[destNodeId] = newDist;
+	if (isTrackingPaths) {
+	  preds[destNodeId] = srcNodeId;
+	}
+	frontier.push(newDist, destNodeId);
+      }
+    });
+  }
+}
+
+// Each search only stops once the smallest keys of both frontiers add
+// up to the best path found so far: every path left goes through a
+// node at least that far from the source and the target. Keys of
+// entries that were improved since are below the node's distance, so
+// they only make the check stricter.
+//
+// The path goes through the node where the best path was found. The
+// backward predecessors from there on are turned around into forward
+// ones.
+template <typename distT>
+void basicDeltaStepping<distT>::bidirectionalDijkstra()
+{
+  if (targetNode == knoTarget) {
+    throw invalid_argument{"The bidirectional-dijkstra mode needs a"\
+			     " target node"};
+  }
+  const graphT& reverse = getReverseGraph();
+  DS::radixHeap<distT, nodeIdT> forwardFrontier;
+  DS::radixHeap<distT, nodeIdT> backwardFrontier;
+  resetDists(dists, preds, touched);
+  resetDists(reverseDists, reversePreds, reverseTouched);
+  dists[sourceNode] = 0;
+  reverseDists[targetNode] = 0;
+  touched.push_back(sourceNode);
+  reverseTouched.push_back(targetNode);
+  forwardFrontier.push(0, sourceNode);
+  backwardFrontier.push(0, targetNode);
+  distT bestDist = sourceNode == targetNode ? 0 : infDist;
+  nodeIdT meetNode = sourceNode == targetNode ? sourceNode : knoPred;
+  while (!forwardFrontier.empty() && !backwardFrontier.empty()) {
+    const uint64_t minPathDist =
+      static_cast<uint64_t>(forwardFrontier.top().first) +
+      backwardFrontier.top().first;
+    if (minPathDist >= bestDist) {
+      break;
+    }
+    // The smaller frontier is the cheaper one to grow.
+    if (forwardFrontier.size() <= backwardFrontier.size()) {
+      bidirectionalStep(*graph, forwardFrontier, dists, preds, touched,
+			reverseDists, bestDist, meetNode);
+    }
+    else {
+      bidirectionalStep(reverse, backwardFrontier, reverseDists,
+			reversePreds, reverseTouched, dists, bestDist,
+			meetNode);
+    }
+  }
+  // The nodes after the meeting node may not have been reached by the
+  // forward search, and are only touched now.
+  if (dists[targetNode] == infDist && bestDist != infDist) {
+    touched.push_back(targetNode);
+  }
+  dists[targetNode] = bestDist;
+  if (isTrackingPaths && meetNode != knoPred) {
+    for (nodeIdT cur = meetNode; cur != targetNode; cur = reversePreds[cur]) {
+      if (dists[reversePreds[cur]] == infDist) {
+	touched.push_back(reversePreds[cur]);
+      }
+      preds[reversePreds[cur]] = cur;
+    }
+  }
+}
+
 //===----------------------------------------------------------===//
 // Algorithm closest to the original descrition by Meyer, 1998
 //===----------------------------------------------------------===//
-void deltaStepping::original()
+template <typename distT>
+void basicDeltaStepping<distT>::original()
 {
   LOG(ALG_DELTASTEPPING_DEBUG, "Start -- deltaStepping::original");
   preprocessing();
@@ -182,12 +504,17 @@ void deltaStepping::original()
     buckT* minBuck = getMinBuck();
     if (minBuck == nullptr) // Means bucks is empty
       break;
+    if (isTargetSettled())
+      break;
+    if (ALG_DELTASTEPPING_STATS) {
+      ++stats.numBuckets;
+    }
     rm.reset();
     while (!minBuck->empty()) {
       if (ALG_DELTASTEPPING_DEBUG)
         printBuck(*minBuck);
       // Find requests for light edges
-      req = findRequests(*minBuck, 0);
+      req = findRequests(*minBuck, klightMode);
       if (ALG_DELTASTEPPING_DEBUG)
 	printReq(req);
       bitsetListUnion(rm, *minBuck);
@@ -197,12 +524,14 @@ void deltaStepping::original()
       minBuck->clear();
       // Relax the light edges requests (may reintroduce some nodes)
       relaxRequests(req);
+      if (ALG_DELTASTEPPING_STATS) {
+	++stats.numPhases;
+	stats.numReinsertions += minBuck->size();
+      }
     }
     // Process requests for heavy edges
-    req = findRequests(rm, 1);
+    req = findRequests(rm, kheavyMode);
     relaxRequests(req);
-    // Recycle buckets
-    recycleBucks();
   }
   LOG(ALG_DELTASTEPPING_DEBUG, "End -- deltaStepping::original");
 }
@@ -210,81 +539,92 @@ void deltaStepping::original()
 //===----------------------------------------------------------===//
 // Parallel algorithm
 //===----------------------------------------------------------===//
-void deltaStepping::parallel()
+template <typename distT>
+void basicDeltaStepping<distT>::parallel()
 {
   LOG(ALG_DELTASTEPPING_DEBUG, "Start -- deltastepping::parallel");
   preprocessingPrl();
 
   // Shared vars
-  unsigned gMinBuckIdx = getMinBuckIdx();
-  buckT* gMinBuck = &bucks.at(gMinBuckIdx);
-  unsigned nextGMinBuckIdx = maxUns;
+  buckNumT gMinBuckIdx = getMinBuckIdx();
+  buckT* gMinBuck = &bucks.at(0);
   unsigned prevGBuckSz = 0;
   unsigned gMinBuckStartIdx = 0;
   
+  prepareLightPhase(gMinBuck, gMinBuckStartIdx);
   #pragma omp parallel num_threads(numThreads)
   {
     lBucksT lBucks; // Local buckets
-    while (gMinBuckIdx != maxUns) {
+    lBuckT settled; // Nodes whose light edges this thread relaxed
+    while (gMinBuckIdx != noBuck) {
       #pragma omp single nowait
       prevGBuckSz = gMinBuck->size();
-      #pragma omp for nowait schedule(dynamic, 64)
-      for (unsigned i = gMinBuckStartIdx; i < gMinBuck->size(); ++i) {
-	nodeIdT srcNode = gMinBuck->at(i);
-	relaxEdgesPrl(srcNode, lBucks);
-      }
-      copyToGBuck(bucks, lBucks);
+      runLightPhase(settled, lBucks);
+      // Nobody may append to gMinBuck while it is still being read. The
+      // merge only grows the buckets once every thread got to it.
+      mergeToGBucks(lBucks);
       lBucks.clear();
-      #pragma omp barrier
+      barrier();
+      relaxHeavyIfSettled(prevGBuckSz, gMinBuck, settled, lBucks);
       #pragma omp single nowait
-      updateIdxs(prevGBuckSz, &gMinBuck, gMinBuckIdx, gMinBuckStartIdx);
-      #pragma omp barrier
+      {
+	updateIdxs(prevGBuckSz, &gMinBuck, gMinBuckIdx, gMinBuckStartIdx);
+	if (gMinBuckIdx != noBuck) {
+	  prepareLightPhase(gMinBuck, gMinBuckStartIdx);
+	}
+      }
+      barrier();
     }
+    mergeTouched(lBucks);
   }
-  postprocessingPrl();
-  
+  unpackDistPreds();
+  sumThreadStats();
   LOG(ALG_DELTASTEPPING_DEBUG, "End -- deltastepping::parallel");
 }
 
 //===----------------------------------------------------------===//
 // Parallel algorithm with bucket fusion
 //===----------------------------------------------------------===//
-void deltaStepping::parallelBucketFusion()
+template <typename distT>
+void basicDeltaStepping<distT>::parallelBucketFusion()
 {
   LOG(ALG_DELTASTEPPING_DEBUG, "Start -- deltaStepping::parallelBucketFusion");
   
   preprocessingPrl();
 
   // Shared vars
-  unsigned gMinBuckIdx = getMinBuckIdx();
-  buckT* gMinBuck = &bucks.at(gMinBuckIdx);
-  unsigned nextGMinBuckIdx = maxUns;
+  buckNumT gMinBuckIdx = getMinBuckIdx();
+  buckT* gMinBuck = &bucks.at(0);
   unsigned prevGBuckSz = 0;
   unsigned gMinBuckStartIdx = 0;
   
+  prepareLightPhase(gMinBuck, gMinBuckStartIdx);
   #pragma omp parallel num_threads(numThreads)
   {
     lBucksT lBucks; // Local buckets
-    while (gMinBuckIdx != maxUns) {
+    lBuckT settled; // Nodes whose light edges this thread relaxed
+    while (gMinBuckIdx != noBuck) {
       #pragma omp single nowait
       prevGBuckSz = gMinBuck->size();
-      #pragma omp for nowait schedule(dynamic, 64)
-      for (unsigned i = gMinBuckStartIdx; i < gMinBuck->size(); ++i) {
-	nodeIdT srcNode = gMinBuck->at(i);
-	relaxEdgesPrl(srcNode, lBucks);
-      }
-      bucketFusion(lBucks);
-      #pragma omp barrier
-      copyToGBuck(bucks, lBucks);
+      runLightPhase(settled, lBucks);
+      bucketFusion(lBucks, settled);
+      mergeToGBucks(lBucks);
       lBucks.clear();
-      #pragma omp barrier
+      barrier();
+      relaxHeavyIfSettled(prevGBuckSz, gMinBuck, settled, lBucks);
       #pragma omp single nowait
-      updateIdxs(prevGBuckSz, &gMinBuck, gMinBuckIdx, gMinBuckStartIdx);
-      #pragma omp barrier
+      {
+	updateIdxs(prevGBuckSz, &gMinBuck, gMinBuckIdx, gMinBuckStartIdx);
+	if (gMinBuckIdx != noBuck) {
+	  prepareLightPhase(gMinBuck, gMinBuckStartIdx);
+	}
+      }
+      barrier();
     }
+    mergeTouched(lBucks);
   }
-  
-  postprocessingPrl();
+  unpackDistPreds();
+  sumThreadStats();
   
   LOG(ALG_DELTASTEPPING_DEBUG, "End -- deltaStepping::parallelBucketFusion");
 }
@@ -293,87 +633,367 @@ void deltaStepping::parallelBucketFusion()
 //===----------------------------------------------------------===//
 // Auxiliary procedures
 //===----------------------------------------------------------===//
+template <typename distT>
 inline
-void deltaStepping::preprocessingPrl()
+void basicDeltaStepping<distT>::preprocessingPrl()
 {
   initBucksDists();
-  locks = new omp_lock_t[bucks.size()];
+  const unsigned numNodes = graph->getNumNodes();
+  isPacked = isTrackingPaths && kisPackable;
+  if (isPacked) {
+    if (distPreds.size() != numNodes) {
+      fillByParts(distPreds, packDistPred(infDist, knoPred));
+    }
+    distPreds[sourceNode] = packDistPred<distT>(0, knoPred);
+  }
+  else if (isTrackingPaths && pathLocks.empty()) {
+    pathLocks.assign(kpathLocks, 0);
+  }
+  if (denseFrontier.size() != (numNodes + 63) / 64) {
+    denseFrontier.assign((numNodes + 63) / 64, 0);
+  }
   for (unsigned i = 0; i < bucks.size(); ++i) {
-    omp_init_lock(&locks[i]);
+    gBuckSzs[i] = bucks[i].size();
   }
+  numReserved = 0;
 }
 
+template <typename distT>
 inline
-void deltaStepping::preprocessing()
+void basicDeltaStepping<distT>::preprocessing()
 {
   // Allocate buckets and distances
   initBucksDists();
-  rm.resize(diGraph->getNumNodes());
+  rm.resize(graph->getNumNodes());
+  rm.reset();
 }
 
+// The scan goes through the window from the current bucket on, so
+// that buckets are taken in order of distance. Nodes are then settled
+// for good once their bucket is left behind. The overflow may have
+// nodes for any bucket from ~overflowMinBuck~ on, so the scan does
+// not go past it without moving them into the window first.
+template <typename distT>
 inline
-void deltaStepping::postprocessingPrl()
-{
-  for (unsigned i = 0; i < sizeof(locks) / sizeof(*locks); ++i) {
-    omp_destroy_lock(&locks[i]);
+typename basicDeltaStepping<distT>::buckNumT
+basicDeltaStepping<distT>::getMinBuckIdx() {
+  while (true) {
+    for (unsigned i = 0;
+	 i < bucks.size() && minBuckNum + i < overflowMinBuck; ++i) {
+      if (!bucks.at(i).empty()) {
+	advanceWindow(i);
+	return minBuckNum;
+      }
+    }
+    if (overflow.empty()) {
+      return noBuck;
+    }
+    advanceWindow(overflowMinBuck - minBuckNum);
+    refillFromOverflow();
   }
-  delete[] locks;
+}
+  
+template <typename distT>
+inline
+buckT* basicDeltaStepping<distT>::getMinBuck()
+{
+  const buckNumT minBuckIdx = getMinBuckIdx();
+  return minBuckIdx == noBuck ? nullptr : &bucks.at(0);
 }
 
+// The buckets passed over must be empty. They become the last ones of
+// the window.
+template <typename distT>
 inline
-unsigned deltaStepping::getMinBuckIdx() {
-  for (unsigned i = 0; i < bucks.size(); ++i) {
-    if (!bucks.at(i).empty()) {
-      return i;
+void basicDeltaStepping<distT>::advanceWindow(const buckNumT numBucks)
+{
+  bucks.setBegin(bucks.index(numBucks % bucks.size()));
+  minBuckNum += numBucks;
+}
+
+// Divided in double precision, which holds any distance up to 2^53
+// exactly: with fewer bits, distances a heavy edge apart could round
+// to the same bucket.
+template <typename distT>
+inline
+typename basicDeltaStepping<distT>::buckNumT
+basicDeltaStepping<distT>::buckNumOf(const distT dist) const
+{
+  return static_cast<buckNumT>(dist / static_cast<double>(delta));
+}
+
+// A node whose distance went down since it was put in the overflow
+// was put in a bucket again then. If that bucket is behind the window,
+// the node is dropped; otherwise it may now be twice in its bucket,
+// which only costs a second look at its edges.
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::refillFromOverflow()
+{
+  const buckNumT windowEnd = minBuckNum + bucks.size();
+  unsigned numKept = 0;
+  overflowMinBuck = noBuck;
+  for (auto nodeId : overflow) {
+    const buckNumT buckNum = buckNumOf(getTentativeDist(nodeId));
+    if (buckNum < minBuckNum) {
+      continue;
+    }
+    if (buckNum < windowEnd) {
+      bucks.at(buckNum - minBuckNum).push_back(nodeId);
+    }
+    else {
+      overflow[numKept++] = nodeId;
+      overflowMinBuck = std::min(overflowMinBuck, buckNum);
     }
   }
-  return maxUns;
+  overflow.resize(numKept);
+  for (unsigned i = 0; i < bucks.size(); ++i) {
+    gBuckSzs[i] = bucks[i].size();
+  }
+  gOverflowSz = numKept;
 }
-  
+
+// Called between buckets. Nothing shorter than the bucket about to
+// be processed can still be found, so the target is settled if its
+// distance is in an earlier bucket.
+template <typename distT>
 inline
-buckT* deltaStepping::getMinBuck()
+bool basicDeltaStepping<distT>::isTargetSettled() const
 {
-  for (unsigned i = 0; i < bucks.size(); ++i) {
-    if (!bucks.at(i).empty()) {
-      return &bucks.at(i);
+  if (targetNode == knoTarget) {
+    return false;
+  }
+  const distT targetDist = getTentativeDist(targetNode);
+  if (targetDist == infDist) {
+    return false;
+  }
+  return buckNumOf(targetDist) < minBuckNum;
+}
+
+template <typename distT>
+inline
+distT basicDeltaStepping<distT>::getTentativeDist(const nodeIdT nodeId) const
+{
+  return isPacked ? unpackDist<distT>(distPreds[nodeId]) : dists[nodeId];
+}
+
+// Splits the packed distances of a parallel run back into ~dists~
+// and ~preds~, and resets them for the next run. Only touched nodes
+// have anything to unpack.
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::unpackDistPreds()
+{
+  if (!isPacked) {
+    return;
+  }
+  const unsigned numTouched = touched.size();
+  #pragma omp parallel for num_threads(numThreads) schedule(static)
+  for (unsigned i = 0; i < numTouched; ++i) {
+    const nodeIdT nodeId = touched[i];
+    dists[nodeId] = unpackDist<distT>(distPreds[nodeId]);
+    preds[nodeId] = unpackPred(distPreds[nodeId]);
+    distPreds[nodeId] = packDistPred(infDist, knoPred);
+  }
+  isPacked = false;
+}
+
+// Full runs move every node to its ID in ~order~. Runs with a target
+// only move the target and the nodes of its path, which are all that
+// is valid after them, so that they keep costing in proportion to the
+// nodes they reach.
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::mapBack()
+{
+  const unsigned numNodes = graph->getNumNodes();
+  outDists.resize(numNodes, infDist);
+  if (isTrackingPaths) {
+    outPreds.resize(numNodes, knoPred);
+  }
+  else {
+    outPreds.clear();
+  }
+  auto oldPred = [&](const nodeIdT nodeId) {
+    return preds[nodeId] == knoPred ? knoPred : order->toOld(preds[nodeId]);
+  };
+  if (targetNode == knoTarget) {
+    #pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (unsigned i = 0; i < numNodes; ++i) {
+      outDists[order->toOld(i)] = dists[i];
+      if (isTrackingPaths) {
+	outPreds[order->toOld(i)] = oldPred(i);
+      }
     }
+    return;
+  }
+  outDists[order->toOld(targetNode)] = dists[targetNode];
+  if (!isTrackingPaths) {
+    return;
+  }
+  nodeIdT cur = targetNode;
+  for (unsigned i = 0; i < numNodes && cur != knoPred; ++i) {
+    outDists[order->toOld(cur)] = dists[cur];
+    outPreds[order->toOld(cur)] = oldPred(cur);
+    cur = preds[cur];
   }
-  return nullptr;
 }
 
+// Called by every thread once it is done with the run.
+template <typename distT>
 inline
-void deltaStepping::bucketFusion(lBucksT& lBucks)
+void basicDeltaStepping<distT>::mergeTouched(const lBucksT& lBucks)
 {
-  if (!lBucks.empty()) {
-    unsigned lbIdx = 0;
-    while (lBucks[lbIdx].empty()) lbIdx++;
-    while (!lBucks[lbIdx].empty() &&
-	   lBucks[lbIdx].size() < kminBuckThreshold) {
-      // This copy is necessary, because we want to remove nodes from the
-      //   local bucket, which is not a normal procedure. Generally, we just
-      //   dump new nodes on the global bucket.
-      //
-      // In bucket fusion, if the bucket is small enough, we do all the work
-      //   locally, instead of copying it to the global bucket for later
-      //   processing.
-      auto lBuckCopy = lBucks[lbIdx];
-      lBucks[lbIdx].resize(0);
-      for (auto srcNode : lBuckCopy) {
-	relaxEdgesPrl(srcNode, lBucks);
+  #pragma omp critical (deltaSteppingTouched)
+  touched.insert(touched.end(), lBucks.touched.begin(), lBucks.touched.end());
+}
+
+// Thread counters are only allocated when counting.
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::initStats()
+{
+  stats = runStats();
+  if (ALG_DELTASTEPPING_STATS) {
+    threadStats.assign(numThreads, paddedStats());
+  }
+}
+
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::sumThreadStats()
+{
+  for (const auto& perThread : threadStats) {
+    stats.add(perThread.stats);
+  }
+  threadStats.clear();
+}
+
+template <typename distT>
+inline
+runStats& basicDeltaStepping<distT>::getThreadStats()
+{
+  return threadStats[omp_get_thread_num()].stats;
+}
+
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::barrier()
+{
+  if (!ALG_DELTASTEPPING_STATS) {
+    #pragma omp barrier
+    return;
+  }
+  const statsClockT::time_point time1 = statsClockT::now();
+  #pragma omp barrier
+  getThreadStats().barrierTime +=
+    chrono::duration<double>(statsClockT::now() - time1).count();
+}
+
+// Built on the first bidirectional run over a graph, and kept for
+// the next ones.
+template <typename distT>
+inline
+const graphT& basicDeltaStepping<distT>::getReverseGraph()
+{
+  if (reverseOf != graph) {
+    reverseGraph = graph->reverse(numThreads);
+    reverseOf = graph;
+  }
+  return *reverseGraph;
+}
+
+// Settles the closest node of ~frontier~, if its entry is still
+// current, and checks every edge out of it for a shorter path.
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::bidirectionalStep(
+  const graphT& stepGraph, DS::radixHeap<distT, nodeIdT>& frontier,
+  distsT& stepDists, predsT& stepPreds, std::vector<nodeIdT>& stepTouched,
+  const distsT& otherDists, distT& bestDist, nodeIdT& meetNode)
+{
+  const auto top = frontier.pop();
+  const distT srcDist = top.first;
+  const nodeIdT srcNodeId = top.second;
+  if (srcDist != stepDists[srcNodeId]) {
+    return;
+  }
+  stepGraph.forEdges(stepGraph.outBegin(srcNodeId),
+		     stepGraph.outEnd(srcNodeId),
+		     [&](const nodeIdT destNodeId, const weightT edgeWeight) {
+    const distT newDist = srcDist + edgeWeight;
+    if (newDist < stepDists[destNodeId]) {
+      if (stepDists[destNodeId] == infDist) {
+	stepTouched.push_back(destNodeId);
+      }
+      stepDists[destNodeId] = newDist;
+      if (isTrackingPaths) {
+	stepPreds[destNodeId] = srcNodeId;
+      }
+      frontier.push(newDist, destNodeId);
+      // Both halves may be as long as a path, so their sum is taken
+      // on 64 bits; what is kept is a path, and fits distT.
+      const uint64_t pathDist =
+	static_cast<uint64_t>(newDist) + otherDists[destNodeId];
+      if (otherDists[destNodeId] != infDist && pathDist < bestDist) {
+	bestDist = static_cast<distT>(pathDist);
+	meetNode = destNodeId;
       }
     }
+  });
+}
+
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::bucketFusion(lBucksT& lBucks, lBuckT& settled)
+{
+  std::vector<lBuckT>& window = lBucks.window;
+  lBuckT& fusionBuck = lBucks.fusionBuck;
+  unsigned lbIdx = 0;
+  while (lbIdx < lBucks.windowSz && window[lbIdx].empty()) lbIdx++;
+  while (lbIdx < lBucks.windowSz && !window[lbIdx].empty() &&
+	 window[lbIdx].size() < kminBuckThreshold) {
+    // The bucket is moved out, because we want to remove nodes from the
+    //   local bucket, which is not a normal procedure. Generally, we just
+    //   dump new nodes on the global bucket. Swapping it with the empty
+    //   ~fusionBuck~ keeps the memory of both.
+    //
+    // In bucket fusion, if the bucket is small enough, we do all the work
+    //   locally, instead of copying it to the global bucket for later
+    //   processing.
+    fusionBuck.swap(window[lbIdx]);
+    if (ALG_DELTASTEPPING_STATS) {
+      ++getThreadStats().numFusionIters;
+    }
+    for (auto srcNode : fusionBuck) {
+      relaxLightPrl(srcNode, lBucks);
+      settled.push_back(srcNode);
+    }
+    fusionBuck.clear();
   }
 }
 
+template <typename distT>
 inline
-void deltaStepping::updateIdxs(unsigned& prevGBuckSz, buckT** gMinBuck,
-			       unsigned& gMinBuckIdx, unsigned& gMinBuckStartIdx)
+void basicDeltaStepping<distT>::updateIdxs(unsigned& prevGBuckSz,
+					   buckT** gMinBuck,
+					   buckNumT& gMinBuckIdx,
+					   unsigned& gMinBuckStartIdx)
 {
   unsigned updtGBuckSz = (*gMinBuck)->size();
+  if (ALG_DELTASTEPPING_STATS) {
+    ++stats.numPhases;
+    stats.numReinsertions += updtGBuckSz - prevGBuckSz;
+    stats.numBuckets += prevGBuckSz == updtGBuckSz;
+  }
   if (prevGBuckSz == updtGBuckSz) { // No reinsertions!
     (*gMinBuck)->clear();
+    gBuckSzs[bucks.index(0)] = 0;
     gMinBuckIdx = getMinBuckIdx();
-    *gMinBuck = &bucks.at(gMinBuckIdx);
+    if (isTargetSettled()) {
+      gMinBuckIdx = noBuck;
+    }
+    *gMinBuck = &bucks.at(0);
     gMinBuckStartIdx = 0;
   }
   else {
@@ -381,201 +1001,637 @@ void deltaStepping::updateIdxs(unsigned& prevGBuckSz, buckT** gMinBuck,
   }
 }
 
+// The next light phase is split while the other threads wait at the
+// end of the current one, so it costs no extra barrier. Some threads
+// may still be checking prevGBuckSz then (see ~relaxHeavyIfSettled~),
+// so it is not set here.
+template <typename distT>
+inline
+void
+basicDeltaStepping<distT>::prepareLightPhase(const buckT* gMinBuck,
+					     const unsigned gMinBuckStartIdx)
+{
+  const nodeIdT* frontier = gMinBuck->data() + gMinBuckStartIdx;
+  const unsigned frontierSz = gMinBuck->size() - gMinBuckStartIdx;
+  isDenseFrontier = frontierSz > graph->getNumNodes() / kdenseDivisor;
+  if (isDenseFrontier) {
+    denseSrc = frontier;
+    denseSrcSz = frontierSz;
+    if (ALG_DELTASTEPPING_STATS) {
+      ++stats.numDensePhases;
+    }
+    return;
+  }
+  scheduler.prepare(*graph, frontier, frontierSz, numThreads, parts);
+}
+
+// A node may come in many parts, when its edges are spread over many
+// chunks. Only its owner counts it as settled.
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::runLightPhase(lBuckT& settled, lBucksT& lBucks)
+{
+  if (isDenseFrontier) {
+    runDenseLightPhase(settled, lBucks);
+    return;
+  }
+  scheduler.run(omp_get_thread_num(),
+		[&](const nodeIdT srcNode, const edgeIdT begin,
+		    const edgeIdT end, const bool isOwner) {
+		  relaxEdgesPrl(srcNode, begin, end, lBucks);
+		  if (isOwner) {
+		    settled.push_back(srcNode);
+		  }
+		});
+}
+
+// The threads first set the bits of their part of the frontier, and
+// then take the words of the bitmap in chunks, clearing them as they
+// go. Nobody relaxes anything before the bitmap is complete, so the
+// distances read to drop stale nodes do not change under it. As with
+// the sparse frontier, gMinBuck is no longer read once a thread gets
+// to the merge.
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::runDenseLightPhase(lBuckT& settled,
+						   lBucksT& lBucks)
+{
+  uint64_t* words = denseFrontier.data();
+  #pragma omp for schedule(static)
+  for (unsigned i = 0; i < denseSrcSz; ++i) {
+    const nodeIdT nodeId = denseSrc[i];
+    if (buckNumOf(getTentativeDist(nodeId)) != minBuckNum) {
+      continue;
+    }
+    const uint64_t bit = uint64_t(1) << (nodeId % 64);
+    if ((atomicOps<uint64_t>::load(&words[nodeId / 64]) & bit) == 0) {
+      atomicOps<uint64_t>::fetchOr(&words[nodeId / 64], bit);
+    }
+  }
+  const unsigned numWords = static_cast<unsigned>(denseFrontier.size());
+  #pragma omp for schedule(dynamic, kdenseChunkWords) nowait
+  for (unsigned w = 0; w < numWords; ++w) {
+    uint64_t word = words[w];
+    if (word == 0) {
+      continue;
+    }
+    words[w] = 0;
+    for (; word != 0; word &= word - 1) {
+      const nodeIdT srcNode = w * 64 + __builtin_ctzll(word);
+      relaxLightPrl(srcNode, lBucks);
+      settled.push_back(srcNode);
+    }
+  }
+}
+
+// The light phases of the current bucket are over once one of them
+// does not reinsert any node. Then, every node that was settled in it
+// has its heavy edges relaxed. Heavy edges are longer than delta,
+// and buckets are taken in order, so these never lead back into the
+// current bucket. Every thread makes its check before it gets to the
+// merge, and the merge does not grow any bucket before every thread
+// got to it.
+template <typename distT>
 inline
-void deltaStepping::initBucksDists()
+void basicDeltaStepping<distT>::relaxHeavyIfSettled(const unsigned prevGBuckSz,
+						    const buckT* gMinBuck,
+						    lBuckT& settled,
+						    lBucksT& lBucks)
+{
+  if (prevGBuckSz != gMinBuck->size()) {
+    return;
+  }
+  for (auto srcNode : settled) {
+    relaxHeavyPrl(srcNode, lBucks);
+  }
+  settled.clear();
+  mergeToGBucks(lBucks);
+  lBucks.clear();
+  barrier();
+}
+
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::initBucksDists()
 {
   initBucks();
   initDists();
+  initSimdFilter();
+}
+
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::initSimdFilter()
+{
+  const bool isFilterable = graph->getPacked() == nullptr &&
+    graph->getNumNodes() <= relaxKernel<distT>::kmaxNodes;
+  simdFilter = isFilterable ? relaxKernel<distT>::select() : nullptr;
 }
 
+template <typename distT>
 inline
-void deltaStepping::initBucks()
+void basicDeltaStepping<distT>::initBucks()
 {
-  const unsigned numBuckets = 
-    static_cast<unsigned>(ceil(diGraph->getMaxEdgeWeight() / delta) + 1);
+  const double numReachable = ceil(graph->getMaxEdgeWeight() / delta) + 1;
+  const unsigned numBuckets =
+    static_cast<unsigned>(std::min<double>(numReachable, kmaxWindowBucks));
   LOGATT(ALG_DELTASTEPPING_DEBUG, numBuckets);
 
+  // Buckets left by a previous run keep their memory. They are only
+  // all empty if it did not stop at a target.
   bucks.resize(numBuckets);
+  for (auto& buck : bucks) {
+    buck.clear();
+  }
+  bucks.setBegin(0);
+  minBuckNum = 0;
+  overflow.clear();
+  overflowMinBuck = noBuck;
+  gBuckSzs.assign(numBuckets, 0);
+  gOverflowSz = 0;
 }
 
+template <typename distT>
 inline
-void deltaStepping::initDists()
+void basicDeltaStepping<distT>::initDists()
 {
   // Initialize the distances to infinity, except for sourceNode
-  dists.resize(diGraph->size(), infDist);
-  relax(sourceNode, 0);
+  resetDists(dists, preds, touched);
+  relax(sourceNode, 0, knoPred);
 }
 
+// Everything is reset at once when the number of nodes changed, or
+// when so many nodes were touched that going through them would cost
+// more. Predecessors from the last run that tracked paths are
+// dropped, so that ~getPreds~ does not hand them out for this one.
+template <typename distT>
 inline
-reqT deltaStepping::findRequests(const buckT& curBuck, const unsigned mode)
+void basicDeltaStepping<distT>::resetDists(distsT& toReset, predsT& resetPreds,
+					   std::vector<nodeIdT>& touchedNodes)
 {
-  switch (mode) {
-    case 0:
-      return findRequestsAux(curBuck, isLight);
-    case 1:
-      return findRequestsAux(curBuck, isHeavy);
-    default:
-      throw std::invalid_argument{
-        string("(findRequests) Invalid mode ") + to_string(mode)};
+  const unsigned numNodes = graph->size();
+  const bool isFullReset = toReset.size() != numNodes ||
+    touchedNodes.size() > numNodes / kfullResetDivisor;
+  if (isFullReset) {
+    fillByParts(toReset, infDist);
   }
+  else {
+    for (auto nodeId : touchedNodes) {
+      toReset[nodeId] = infDist;
+    }
+  }
+  if (!isTrackingPaths) {
+    resetPreds.clear();
+  }
+  else if (isFullReset || resetPreds.size() != numNodes) {
+    resetPreds.assign(numNodes, knoPred);
+  }
+  else {
+    for (auto nodeId : touchedNodes) {
+      resetPreds[nodeId] = knoPred;
+    }
+  }
+  touchedNodes.clear();
+}
+
+template <typename distT>
+template <typename arrayT, typename valueT>
+inline
+void basicDeltaStepping<distT>::fillByParts(arrayT& array, const valueT value)
+{
+  const unsigned numNodes = graph->size();
+  if (array.size() != numNodes) {
+    arrayT(numNodes).swap(array);
+  }
+  graphT::forParts(parts, [&](const unsigned, const nodeIdT first,
+			      const nodeIdT last) {
+		     std::fill(array.begin() + first, array.begin() + last,
+			       value);
+		   });
 }
 
+template <typename distT>
 inline
-reqT deltaStepping::findRequestsAux(const buckT& curBuck, 
-                                    bool (*f)(weightT))
+typename basicDeltaStepping<distT>::reqT
+basicDeltaStepping<distT>::findRequests(const buckT& curBuck,
+					const unsigned mode)
+{
+  checkRequestMode(mode);
+  return findRequestsAux(curBuck, mode == kheavyMode);
+}
+
+template <typename distT>
+inline
+typename basicDeltaStepping<distT>::reqT
+basicDeltaStepping<distT>::findRequestsAux(const buckT& curBuck,
+					   const bool isHeavy)
 {
   LOG(ALG_DELTASTEPPING_DEBUG, "Start -- findRequestsAux");
   reqT req;
   for (auto srcNodeId : curBuck) {
-    auto* edges = diGraph->at(srcNodeId)->getOutEdges();
-    if (edges != nullptr) {
-      for (unsigned i = 0; i < edges->size(); ++i) {
-	nodeIdT& destNodeId = edges->at(i).first;
-	weightT& edgeWeight = edges->at(i).second;
-	if (f(edgeWeight)) {
-	  req.push_back(std::make_pair(destNodeId,
-				       dists.at(srcNodeId) + edgeWeight));
-	}
-      }
-    }
+    findNodeRequests(srcNodeId, isHeavy, req);
   }
   return req;
 }
 
+template <typename distT>
 inline
-reqT deltaStepping::findRequests(const boost::dynamic_bitset<>& curBuck,
-                                 const unsigned mode)
+typename basicDeltaStepping<distT>::reqT
+basicDeltaStepping<distT>::findRequests(const boost::dynamic_bitset<>& curBuck,
+					const unsigned mode)
 {
-  switch (mode) {
-    case 0:
-      return findRequestsAux(curBuck, isLight);
-    case 1:
-      return findRequestsAux(curBuck, isHeavy);
-    default:
-      throw std::invalid_argument{
-        string("(findRequests) Invalid mode ") + to_string(mode)};
-  }
+  checkRequestMode(mode);
+  return findRequestsAux(curBuck, mode == kheavyMode);
 }
 
+template <typename distT>
 inline
-reqT deltaStepping::findRequestsAux(const boost::dynamic_bitset<>& curBuck, 
-                                    bool (*f)(weightT))
+typename basicDeltaStepping<distT>::reqT
+basicDeltaStepping<distT>::findRequestsAux(
+  const boost::dynamic_bitset<>& curBuck, const bool isHeavy)
 {
   reqT req;
   for (unsigned srcNodeId = 0; srcNodeId < curBuck.size(); ++srcNodeId) {
     if (curBuck[srcNodeId]) {
-      auto* edges = diGraph->at(srcNodeId)->getOutEdges();
-      if (edges != nullptr) {
-        for (unsigned i = 0; i < edges->size(); ++i) {
-	  nodeIdT& destNodeId = edges->at(i).first;
-          weightT& edgeWeight = edges->at(i).second;
-          if (f(edgeWeight)) {
-            req.push_back(std::make_pair(destNodeId,
-					 dists.at(srcNodeId) + edgeWeight));
-          }
-        }
-      }
+      findNodeRequests(srcNodeId, isHeavy, req);
     }
   }
   return req;
 }
 
+// The light or heavy edges of a node are a contiguous range of its
+// edges (see ~DS::csrGraph::splitLightHeavy~), so no weight needs to
+// be tested here.
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::findNodeRequests(const nodeIdT srcNodeId,
+						 const bool isHeavy, reqT& req)
+{
+  const edgeIdT begin = isHeavy ? graph->lightEnd(srcNodeId)
+				: graph->outBegin(srcNodeId);
+  const edgeIdT end = isHeavy ? graph->outEnd(srcNodeId)
+			      : graph->lightEnd(srcNodeId);
+  const distT srcDist = dists[srcNodeId];
+  const edgeIdT numFound = forLoweringEdges(srcDist, begin, end,
+		  [&](const nodeIdT destNodeId, const weightT edgeWeight) {
+    req.push_back(request{destNodeId, srcDist + edgeWeight, srcNodeId});
+  });
+  // The edges left out would have failed to relax
+  if (ALG_DELTASTEPPING_STATS) {
+    stats.numRelaxAttempts += (end - begin) - numFound;
+  }
+}
+
+// Calls ~visit(target, weight)~ for the edges [begin, end) of a node
+// at ~srcDist~, as ~DS::csrGraph::forEdges~ does. With ~simdFilter~,
+// only the edges through which the distance of their target was
+// lower when it was read are visited; ~visit~ still has to check the
+// distance it lowers. Returns the number of edges visited.
+//
+// Filtered or not, the edges go through the same loop, so that
+// ~visit~ is inlined once rather than called for each edge.
+template <typename distT>
+template <typename visitT>
+inline
+edgeIdT basicDeltaStepping<distT>::forLoweringEdges(const distT srcDist,
+						     const edgeIdT begin,
+						     const edgeIdT end,
+						     visitT visit) const
+{
+  typedef relaxKernel<distT> kernelT;
+  const DS::packedEdges* packed = graph->getPacked();
+  if (packed != nullptr) {
+    packed->forEdges(begin, end, visit);
+    return end - begin;
+  }
+  const bool isFiltered =
+    simdFilter != nullptr && end - begin >= kernelT::kminEdges;
+  nodeIdT outTargets[kernelT::kblockSz + kernelT::kmaxLanes];
+  weightT outWeights[kernelT::kblockSz + kernelT::kmaxLanes];
+  edgeIdT numVisited = 0;
+  for (edgeIdT first = begin; first < end; first += kernelT::kblockSz) {
+    const nodeIdT* targets = graph->getTargets() + first;
+    const weightT* weights = graph->getWeights() + first;
+    unsigned numEdges =
+      static_cast<unsigned>(std::min<edgeIdT>(kernelT::kblockSz, end - first));
+    if (isFiltered) {
+      numEdges = simdFilter(targets, weights, numEdges, srcDist,
+			    dists.data(), outTargets, outWeights);
+      targets = outTargets;
+      weights = outWeights;
+    }
+    for (unsigned i = 0; i < numEdges; ++i) {
+      visit(targets[i], weights[i]);
+    }
+    numVisited += numEdges;
+  }
+  return numVisited;
+}
+
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::checkRequestMode(const unsigned mode)
+{
+  if (mode != klightMode && mode != kheavyMode) {
+    throw std::invalid_argument{
+      string("(findRequests) Invalid mode ") + to_string(mode)};
+  }
+}
+
+template <typename distT>
 inline
-void deltaStepping::relaxRequests(reqT& reqs)
+void basicDeltaStepping<distT>::relaxRequests(reqT& reqs)
 {
+  uint64_t numSuccesses = 0;
   for (auto req : reqs)
-    relax(req.first, req.second);
+    numSuccesses += relax(req.nodeId, req.dist, req.pred);
+  if (ALG_DELTASTEPPING_STATS) {
+    stats.numRelaxAttempts += reqs.size();
+    stats.numRelaxSuccesses += numSuccesses;
+  }
+}
+
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::relaxLightPrl(nodeIdT srcNodeId,
+					      lBucksT& lBucks)
+{
+  relaxEdgesPrl(srcNodeId, graph->outBegin(srcNodeId),
+		graph->lightEnd(srcNodeId), lBucks);
 }
 
+template <typename distT>
 inline
-void deltaStepping::relaxEdgesPrl(nodeIdT srcNodeId, lBucksT& lBucks)
+void basicDeltaStepping<distT>::relaxHeavyPrl(nodeIdT srcNodeId,
+					      lBucksT& lBucks)
 {
+  relaxEdgesPrl(srcNodeId, graph->lightEnd(srcNodeId),
+		graph->outEnd(srcNodeId), lBucks);
+}
+
+template <typename distT>
+inline
+void basicDeltaStepping<distT>::relaxEdgesPrl(nodeIdT srcNodeId,
+					      const edgeIdT begin,
+					      const edgeIdT end,
+					      lBucksT& lBucks)
+{
+  if (isPacked) {
+    relaxEdgesPrlPaths(srcNodeId, begin, end, lBucks);
+    return;
+  }
+  if (isTrackingPaths) {
+    relaxEdgesPrlLocked(srcNodeId, begin, end, lBucks);
+    return;
+  }
   LOG(ALG_DELTASTEPPING_DEBUG, "%u: Start -- relaxEdgesPrl", omp_get_thread_num());
-  auto* edges = diGraph->at(srcNodeId)->getOutEdges();
-  if (edges != nullptr) {
-    for (unsigned i = 0; i < edges->size(); ++i) {
-      nodeIdT& destNodeId = edges->at(i).first;
-      weightT& edgeWeight = edges->at(i).second;
-      
-      distT& oldDist = dists.at(destNodeId);
-      distT newDist = dists.at(srcNodeId) + edgeWeight;
-      if (newDist < oldDist) {
-	#pragma omp atomic write
-	dists[destNodeId] = newDist;
-	unsigned buckPos = newDist / delta;
-	if (buckPos >= lBucks.size()) {
-	  lBucks.resize(buckPos + 1);
-	}
-	lBucks.at(buckPos).push_back(destNodeId);
+  // Other threads may lower dists concurrently, so every access to it
+  // is atomic. A destination node is only pushed by the thread whose
+  // compare-and-swap actually lowered its distance: this is what keeps
+  // a smaller distance from being overwritten, and the bucket from
+  // getting one copy of the node per racing thread.
+  distT* distsArr = dists.data();
+  const distT srcDist = atomicOps<distT>::load(&distsArr[srcNodeId]);
+  uint64_t numSuccesses = 0;
+  forLoweringEdges(srcDist, begin, end,
+		   [&](const nodeIdT destNodeId, const weightT edgeWeight) {
+    const distT newDist = srcDist + edgeWeight;
+    distT prevDist;
+    if (atomicOps<distT>::fetchMin(&distsArr[destNodeId], newDist, prevDist)) {
+      if (prevDist == infDist) {
+	lBucks.touched.push_back(destNodeId);
       }
+      pushLocal(destNodeId, newDist, lBucks);
+      ++numSuccesses;
     }
+  });
+  if (ALG_DELTASTEPPING_STATS) {
+    runStats& threadStats = getThreadStats();
+    threadStats.numRelaxAttempts += end - begin;
+    threadStats.numRelaxSuccesses += numSuccesses;
   }
   LOG(ALG_DELTASTEPPING_DEBUG, "%u: End -- relaxEdgesPrl", omp_get_thread_num());
 }
 
+// The same as ~relaxEdgesPrl~, on distances packed with their
+// predecessors. A node's predecessor is always the one that gave it
+// its distance. Only a shorter distance replaces the packed value, so
+// that equal distances do not push the node again, and so that zero
+// weight edges cannot make predecessors go around in a cycle.
+template <typename distT>
 inline
-void deltaStepping::copyToGBuck(bucksT& gBuck, lBucksT& lBucks)
+void basicDeltaStepping<distT>::relaxEdgesPrlPaths(nodeIdT srcNodeId,
+						   const edgeIdT begin,
+						   const edgeIdT end,
+						   lBucksT& lBucks)
 {
-  LOG(ALG_DELTASTEPPING_DEBUG, "%u: Start -- copyToGBuck", omp_get_thread_num());
-  for (unsigned i = 0; i < lBucks.size(); ++i) {
-    if (!lBucks.at(i).empty()) {
-      omp_set_lock(&locks[i]);
-      lBuckT& lRefBuck = lBucks.at(i);
-      buckT& gRefBuck = bucks.at(i);
-      gRefBuck.insert(gRefBuck.end(), lRefBuck.begin(), lRefBuck.end());
-      omp_unset_lock(&locks[i]);
+  distPredT* distPredsArr = distPreds.data();
+  const distT srcDist =
+    unpackDist<distT>(atomicOps<distPredT>::load(&distPredsArr[srcNodeId]));
+  uint64_t numSuccesses = 0;
+  graph->forEdges(begin, end,
+		  [&](const nodeIdT destNodeId, const weightT edgeWeight) {
+    const distT newDist = srcDist + edgeWeight;
+    const distPredT newDistPred = packDistPred(newDist, srcNodeId);
+    distPredT cur = atomicOps<distPredT>::load(&distPredsArr[destNodeId]);
+    while (newDist < unpackDist<distT>(cur)) {
+      if (atomicOps<distPredT>::compareExchange(&distPredsArr[destNodeId],
+						cur, newDistPred)) {
+	if (unpackDist<distT>(cur) == infDist) {
+	  lBucks.touched.push_back(destNodeId);
+	}
+	pushLocal(destNodeId, newDist, lBucks);
+	++numSuccesses;
+	break;
+      }
     }
+  });
+  if (ALG_DELTASTEPPING_STATS) {
+    runStats& threadStats = getThreadStats();
+    threadStats.numRelaxAttempts += end - begin;
+    threadStats.numRelaxSuccesses += numSuccesses;
   }
-  LOG(ALG_DELTASTEPPING_DEBUG, "%u: End -- copyToGBuck", omp_get_thread_num());
 }
 
+// The same as ~relaxEdgesPrlPaths~, for distances too wide to be
+// packed. A distance is read without the lock first, so that the
+// lock is only taken by edges that look like they lower it; it is
+// then read again under the lock, which is held while the distance
+// and the predecessor are both written.
+template <typename distT>
 inline
-void deltaStepping::relax(nodeIdT nid, distT newDist)
+void basicDeltaStepping<distT>::relaxEdgesPrlLocked(nodeIdT srcNodeId,
+						    const edgeIdT begin,
+						    const edgeIdT end,
+						    lBucksT& lBucks)
 {
-  LOG(ALG_DELTASTEPPING_DEBUG, "relaxing node %u with tentative distance %u",
-      nid, newDist);
-  if (newDist < dists.at(nid)) {
-    bucks.at(newDist / delta).push_back(nid);
-    dists.at(nid) = newDist;
+  distT* distsArr = dists.data();
+  const distT srcDist = atomicOps<distT>::load(&distsArr[srcNodeId]);
+  uint64_t numSuccesses = 0;
+  forLoweringEdges(srcDist, begin, end,
+		   [&](const nodeIdT destNodeId, const weightT edgeWeight) {
+    const distT newDist = srcDist + edgeWeight;
+    if (newDist >= atomicOps<distT>::load(&distsArr[destNodeId])) {
+      return;
+    }
+    unsigned* lock = &pathLocks[destNodeId % kpathLocks];
+    while (atomicOps<unsigned>::exchange(lock, 1, __ATOMIC_ACQUIRE) != 0) {
+      while (atomicOps<unsigned>::load(lock) != 0) {}
+    }
+    const distT prevDist = distsArr[destNodeId];
+    const bool isLowered = newDist < prevDist;
+    if (isLowered) {
+      atomicOps<distT>::store(&distsArr[destNodeId], newDist);
+      preds[destNodeId] = srcNodeId;
+    }
+    atomicOps<unsigned>::store(lock, 0, __ATOMIC_RELEASE);
+    if (isLowered) {
+      if (prevDist == infDist) {
+	lBucks.touched.push_back(destNodeId);
+      }
+      pushLocal(destNodeId, newDist, lBucks);
+      ++numSuccesses;
+    }
+  });
+  if (ALG_DELTASTEPPING_STATS) {
+    runStats& threadStats = getThreadStats();
+    threadStats.numRelaxAttempts += end - begin;
+    threadStats.numRelaxSuccesses += numSuccesses;
   }
 }
 
+// Only nodes whose distance went down are pushed, and nothing in an
+// earlier bucket than the current one can still go down, so ~dist~ is
+// never behind the window.
+template <typename distT>
 inline
-bool deltaStepping::isLight(weightT w)
+void basicDeltaStepping<distT>::pushLocal(const nodeIdT nodeId,
+					  const distT dist, lBucksT& lBucks)
 {
-  return w <= delta;
+  const buckNumT buckNum = buckNumOf(dist);
+  if (buckNum - minBuckNum >= bucks.size()) {
+    lBucks.overflow.push_back(nodeId);
+    lBucks.overflowMinBuck = std::min(lBucks.overflowMinBuck, buckNum);
+    return;
+  }
+  const unsigned buckPos = static_cast<unsigned>(buckNum - minBuckNum);
+  if (buckPos >= lBucks.windowSz) {
+    if (buckPos >= lBucks.window.size()) {
+      lBucks.window.resize(buckPos + 1);
+    }
+    lBucks.windowSz = buckPos + 1;
+  }
+  lBucks.window[buckPos].push_back(nodeId);
 }
 
+// Every thread reserves a slice of each global bucket it has nodes
+// for, with a single fetch-and-add on the size that bucket is going
+// to have. The last thread to do so grows the buckets to those sizes
+// while the others wait at the barrier. Then, every thread copies
+// its nodes into its own slices, without any lock. The overflow is
+// merged the same way.
+template <typename distT>
 inline
-bool deltaStepping::isHeavy(weightT w)
+void basicDeltaStepping<distT>::mergeToGBucks(lBucksT& lBucks)
 {
-  return w > delta;
+  LOG(ALG_DELTASTEPPING_DEBUG, "%u: Start -- mergeToGBucks", omp_get_thread_num());
+  statsClockT::time_point time1;
+  if (ALG_DELTASTEPPING_STATS) {
+    time1 = statsClockT::now();
+  }
+  const std::vector<lBuckT>& window = lBucks.window;
+  std::vector<unsigned>& slices = lBucks.slices;
+  slices.resize(lBucks.windowSz);
+  for (unsigned i = 0; i < lBucks.windowSz; ++i) {
+    if (!window[i].empty()) {
+      slices[i] = atomicOps<unsigned>::fetchAdd(&gBuckSzs[bucks.index(i)],
+						window[i].size());
+    }
+  }
+  unsigned overflowSlice = 0;
+  if (!lBucks.overflow.empty()) {
+    overflowSlice = atomicOps<unsigned>::fetchAdd(&gOverflowSz,
+						  lBucks.overflow.size());
+    atomicOps<buckNumT>::fetchMin(&overflowMinBuck, lBucks.overflowMinBuck);
+  }
+  // The last thread has to see the reservations of all the others.
+  const unsigned numPrevReserved =
+    atomicOps<unsigned>::fetchAdd(&numReserved, 1, __ATOMIC_ACQ_REL);
+  if (numPrevReserved + 1 == static_cast<unsigned>(omp_get_num_threads())) {
+    for (unsigned i = 0; i < bucks.size(); ++i) {
+      bucks[i].resize(gBuckSzs[i]);
+    }
+    overflow.resize(gOverflowSz);
+    numReserved = 0;
+  }
+  if (ALG_DELTASTEPPING_STATS) {
+    getThreadStats().mergeTime +=
+      chrono::duration<double>(statsClockT::now() - time1).count();
+  }
+  barrier();
+  if (ALG_DELTASTEPPING_STATS) {
+    time1 = statsClockT::now();
+  }
+  for (unsigned i = 0; i < lBucks.windowSz; ++i) {
+    if (!window[i].empty()) {
+      std::copy(window[i].begin(), window[i].end(),
+		bucks.at(i).begin() + slices[i]);
+    }
+  }
+  std::copy(lBucks.overflow.begin(), lBucks.overflow.end(),
+	    overflow.begin() + overflowSlice);
+  if (ALG_DELTASTEPPING_STATS) {
+    getThreadStats().mergeTime +=
+      chrono::duration<double>(statsClockT::now() - time1).count();
+  }
+  LOG(ALG_DELTASTEPPING_DEBUG, "%u: End -- mergeToGBucks", omp_get_thread_num());
 }
 
+// Returns whether ~newDist~ was shorter.
+template <typename distT>
 inline
-void deltaStepping::bitsetListUnion(boost::dynamic_bitset<>& bs, 
-                                    const buckT& ls)
+bool basicDeltaStepping<distT>::relax(nodeIdT nid, distT newDist, nodeIdT pred)
 {
-  for (auto nid : ls) {
-    bs[nid] = 1;
+  LOG(ALG_DELTASTEPPING_DEBUG, "relaxing node %u with tentative distance %llu",
+      nid, static_cast<unsigned long long>(newDist));
+  if (newDist < dists.at(nid)) {
+    if (dists[nid] == infDist) {
+      touched.push_back(nid);
+    }
+    const buckNumT buckNum = buckNumOf(newDist);
+    if (buckNum - minBuckNum < bucks.size()) {
+      bucks.at(buckNum - minBuckNum).push_back(nid);
+    }
+    else {
+      overflow.push_back(nid);
+      overflowMinBuck = std::min(overflowMinBuck, buckNum);
+    }
+    dists.at(nid) = newDist;
+    if (isTrackingPaths) {
+      preds[nid] = pred;
+    }
+    return true;
   }
+  return false;
 }
 
+template <typename distT>
 inline
-void deltaStepping::recycleBucks()
+void basicDeltaStepping<distT>::bitsetListUnion(boost::dynamic_bitset<>& bs, 
+						const buckT& ls)
 {
-  unsigned i = 0;
-  while (bucks.at(i).empty() && i < bucks.size()) {
-    ++i;
+  for (auto nid : ls) {
+    bs[nid] = 1;
   }
-  bucks.setBegin(i + bucks.getBegin());
 }
 
+
 //===----------------------------------------------------------===//
 // Debugging procedures
 //===----------------------------------------------------------===//
+template <typename distT>
 inline
-void deltaStepping::printBuck(buckT& buck)
+void basicDeltaStepping<distT>::printBuck(buckT& buck)
 {
   std::cerr << "\n~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n";
   std::cerr << "Printing bucket\n";
@@ -585,19 +1641,21 @@ void deltaStepping::printBuck(buckT& buck)
   std::cerr << "\n~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n";
 }
 
+template <typename distT>
 inline
-void deltaStepping::printReq(reqT& reqs)
+void basicDeltaStepping<distT>::printReq(reqT& reqs)
 {
   std::cerr << "\n~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n";
   std::cerr << "Printing Request\n";
   for (auto req : reqs) {
-    std::cerr << '(' << req.first << ", " << req.second << ") ";
+    std::cerr << '(' << req.nodeId << ", " << req.dist << ") ";
   }
   std::cerr << "\n~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n";
 }
 
+template <typename distT>
 inline
-void deltaStepping::printBs(boost::dynamic_bitset<>& bs)
+void basicDeltaStepping<distT>::printBs(boost::dynamic_bitset<>& bs)
 {
   std::cerr << "\n~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n";
   std::cerr << "Printing Bitset\n";
@@ -609,8 +1667,9 @@ void deltaStepping::printBs(boost::dynamic_bitset<>& bs)
   std::cerr << "\n~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n";
 }
 
+template <typename distT>
 inline
-void deltaStepping::printDists(distsT& dists)
+void basicDeltaStepping<distT>::printDists(distsT& dists)
 {
   std::cerr << "\n~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n";
   std::cerr << "Printing (Tentative) Distances\n";
@@ -622,9 +1681,11 @@ void deltaStepping::printDists(distsT& dists)
   std::cerr << "\n~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n";
 }
 
+template <typename distT>
 inline
-void deltaStepping::assertEqualRes(void (deltaStepping::* f1)(),
-				   void (deltaStepping::* f2)())
+void
+basicDeltaStepping<distT>::assertEqualRes(void (basicDeltaStepping::* f1)(),
+					  void (basicDeltaStepping::* f2)())
 {
   LOG(ALG_DELTASTEPPING_ASSERT, "Start -- assertEqualRes");
   (this->*f1)();
@@ -635,8 +1696,9 @@ void deltaStepping::assertEqualRes(void (deltaStepping::* f1)(),
   LOG(ALG_DELTASTEPPING_ASSERT, "End -- assertEqualRes");
 }
 
+template <typename distT>
 inline
-bool deltaStepping::compareDists(distsT& d1, distsT& d2)
+bool basicDeltaStepping<distT>::compareDists(distsT& d1, distsT& d2)
 {
   if (d1.size() != d2.size()) {
     return false;
@@ -649,5 +1711,15 @@ bool deltaStepping::compareDists(distsT& d1, distsT& d2)
   return true;
 }
 
+bool needsWideDists(const graphT& graph)
+{
+  const uint64_t numNodes = graph.getNumNodes();
+  const uint64_t maxRelaxDist =
+    static_cast<uint64_t>(graph.getMaxEdgeWeight()) * numNodes;
+  return maxRelaxDist >= std::numeric_limits<uint32_t>::max();
 }
 
+template class basicDeltaStepping<uint32_t>;
+template class basicDeltaStepping<uint64_t>;
+
+}
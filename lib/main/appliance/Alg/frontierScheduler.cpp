@@ -0,0 +1,137 @@
+//===----------------------------------------------------------===//
+// Alg module
+//
+// File purpose: ~frontierScheduler~ class implementation. See
+// header file for more detail
+//===----------------------------------------------------------===//
+
+#include "Alg/frontierScheduler.hpp"
+
+using namespace std;
+using namespace Utils;
+
+namespace Alg {
+
+using graphT = DS::csrGraph;
+
+constexpr edgeIdT frontierScheduler::kchunkUnits;
+
+frontierScheduler::frontierScheduler()
+  : graph(nullptr), frontier(nullptr), frontierSz(0),
+    isByPart(ALG_DELTASTEPPING_NUMA && numa::numNodes() > 1), numUnits(0)
+{}
+
+// The prefix sums are done by one thread. They only read the light
+// degree of every node once, in the order of the frontier, which is
+// little next to relaxing the edges themselves.
+void frontierScheduler::prepare(const graphT& graph,
+                                const nodeIdT* frontier,
+                                const unsigned frontierSz,
+                                const unsigned numThreads,
+                                const std::vector<nodeIdT>& parts)
+{
+  this->graph = &graph;
+  this->frontier = frontier;
+  this->frontierSz = frontierSz;
+  const bool isSorted = isByPart && numThreads > 1 &&
+    parts.size() == numThreads + 1;
+  if (isSorted) {
+    sortByPart(parts);
+  }
+  prefix.resize(frontierSz + 1);
+  edgeIdT acc = 0;
+  for (unsigned i = 0; i < frontierSz; ++i) {
+    prefix[i] = acc;
+    const nodeIdT nodeId = this->frontier[i];
+    acc += 1 + graph.lightEnd(nodeId) - graph.outBegin(nodeId);
+  }
+  prefix[frontierSz] = acc;
+  numUnits = acc;
+
+  const unsigned numChunks =
+    static_cast<unsigned>((numUnits + kchunkUnits - 1) / kchunkUnits);
+  ranges.resize(numThreads);
+  if (isSorted) {
+    // A chunk across two parts goes to the thread of the later one
+    for (unsigned t = 0; t < numThreads; ++t) {
+      const unsigned firstChunk =
+        static_cast<unsigned>(prefix[partBegin[t]] / kchunkUnits);
+      const unsigned lastChunk = t + 1 == numThreads ? numChunks :
+        static_cast<unsigned>(prefix[partBegin[t + 1]] / kchunkUnits);
+      ranges[t].word = pack(firstChunk, lastChunk);
+    }
+    return;
+  }
+  for (unsigned t = 0; t < numThreads; ++t) {
+    const unsigned firstChunk =
+      static_cast<unsigned>(static_cast<uint64_t>(numChunks) * t / numThreads);
+    const unsigned lastChunk =
+      static_cast<unsigned>(static_cast<uint64_t>(numChunks) * (t + 1) /
+                            numThreads);
+    ranges[t].word = pack(firstChunk, lastChunk);
+  }
+}
+
+// A counting sort, stable, so that nodes of a part keep the order of
+// the frontier.
+void frontierScheduler::sortByPart(const std::vector<nodeIdT>& parts)
+{
+  const unsigned numParts = static_cast<unsigned>(parts.size()) - 1;
+  partOf.resize(frontierSz);
+  partBegin.assign(numParts + 1, 0);
+  for (unsigned i = 0; i < frontierSz; ++i) {
+    const unsigned p = static_cast<unsigned>(
+      upper_bound(parts.begin() + 1, parts.end() - 1, frontier[i]) -
+      (parts.begin() + 1));
+    partOf[i] = p;
+    ++partBegin[p + 1];
+  }
+  for (unsigned p = 1; p <= numParts; ++p) {
+    partBegin[p] += partBegin[p - 1];
+  }
+  vector<unsigned> pos(partBegin.begin(), partBegin.end() - 1);
+  byPart.resize(frontierSz);
+  for (unsigned i = 0; i < frontierSz; ++i) {
+    byPart[pos[partOf[i]]++] = frontier[i];
+  }
+  frontier = byPart.data();
+}
+
+bool frontierScheduler::takeOwn(const unsigned threadId, unsigned& chunkIdx)
+{
+  uint64_t* word = &ranges[threadId].word;
+  uint64_t cur = atomicOps<uint64_t>::load(word);
+  while (first(cur) < last(cur)) {
+    if (atomicOps<uint64_t>::compareExchange(
+          word, cur, pack(first(cur) + 1, last(cur)))) {
+      chunkIdx = first(cur);
+      return true;
+    }
+  }
+  return false;
+}
+
+// Victims are tried in order, starting from the next thread. The
+// thief's own range is empty, so nobody else writes to it until it
+// gets the stolen chunks.
+bool frontierScheduler::steal(const unsigned threadId)
+{
+  const unsigned numThreads = static_cast<unsigned>(ranges.size());
+  for (unsigned k = 1; k < numThreads; ++k) {
+    uint64_t* word = &ranges[(threadId + k) % numThreads].word;
+    uint64_t cur = atomicOps<uint64_t>::load(word);
+    while (first(cur) < last(cur)) {
+      const unsigned numStolen = (last(cur) - first(cur) + 1) / 2;
+      const unsigned newLast = last(cur) - numStolen;
+      if (atomicOps<uint64_t>::compareExchange(
+            word, cur, pack(first(cur), newLast))) {
+        atomicOps<uint64_t>::store(&ranges[threadId].word,
+                                   pack(newLast, newLast + numStolen));
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+}
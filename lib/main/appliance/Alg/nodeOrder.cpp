@@ -0,0 +1,159 @@
+//===----------------------------------------------------------===//
+// Alg module
+//
+// File purpose: ~nodeOrder~ class implementation. See header file
+// for more detail
+//===----------------------------------------------------------===//
+
+#include "Alg/nodeOrder.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+using namespace std;
+
+namespace Alg {
+
+using graphT = DS::csrGraph;
+
+constexpr const char* nodeOrder::knoneArg;
+constexpr const char* nodeOrder::krcmArg;
+constexpr const char* nodeOrder::kdegreeArg;
+constexpr const char* nodeOrder::kbfsArg;
+
+nodeOrder::nodeOrder(const graphT& graph, const kind orderKind,
+                     const nodeIdT sourceNode) noexcept(false)
+{
+  const unsigned numNodes = graph.getNumNodes();
+  oldIds.reserve(numNodes);
+  switch (orderKind) {
+    case kind::rcm:
+      byRcm(graph);
+      break;
+    case kind::degree:
+      byDegree(graph);
+      break;
+    case kind::bfs:
+      byBfs(graph, sourceNode);
+      break;
+    default:
+      oldIds.resize(numNodes);
+      iota(oldIds.begin(), oldIds.end(), 0);
+      break;
+  }
+  newIds.resize(numNodes);
+  for (unsigned i = 0; i < numNodes; ++i) {
+    newIds[oldIds[i]] = i;
+  }
+}
+
+nodeOrder::kind nodeOrder::parseKind(const std::string& arg) noexcept(false)
+{
+  if (arg == knoneArg) {
+    return kind::none;
+  }
+  if (arg == krcmArg) {
+    return kind::rcm;
+  }
+  if (arg == kdegreeArg) {
+    return kind::degree;
+  }
+  if (arg == kbfsArg) {
+    return kind::bfs;
+  }
+  throw invalid_argument{string("Unknown node order '") + arg + "'"};
+}
+
+unsigned nodeOrder::size() const
+{
+  return static_cast<unsigned>(newIds.size());
+}
+
+nodeIdT nodeOrder::toNew(const nodeIdT oldId) const
+{
+  return newIds[oldId];
+}
+
+nodeIdT nodeOrder::toOld(const nodeIdT newId) const
+{
+  return oldIds[newId];
+}
+
+const std::vector<nodeIdT>& nodeOrder::getNewIds() const
+{
+  return newIds;
+}
+
+// ~oldIds~ doubles as the queue of the searches: the nodes of a
+// search are the ones appended since it started.
+void nodeOrder::traverse(const graphT& graph,
+                         const std::vector<nodeIdT>& starts,
+                         const bool isByDegree)
+{
+  std::vector<bool> isReached(graph.getNumNodes(), false);
+  std::vector<nodeIdT> neighbours;
+  for (auto start : starts) {
+    if (isReached[start]) {
+      continue;
+    }
+    isReached[start] = true;
+    oldIds.push_back(start);
+    for (size_t head = oldIds.size() - 1; head < oldIds.size(); ++head) {
+      const nodeIdT cur = oldIds[head];
+      neighbours.clear();
+      for (edgeIdT e = graph.outBegin(cur); e < graph.outEnd(cur); ++e) {
+        const nodeIdT nodeId = graph.target(e);
+        if (!isReached[nodeId]) {
+          isReached[nodeId] = true;
+          neighbours.push_back(nodeId);
+        }
+      }
+      if (isByDegree) {
+        sort(neighbours.begin(), neighbours.end(),
+             [&](const nodeIdT a, const nodeIdT b) {
+               return graph.outDegree(a) != graph.outDegree(b)
+                 ? graph.outDegree(a) < graph.outDegree(b) : a < b;
+             });
+      }
+      oldIds.insert(oldIds.end(), neighbours.begin(), neighbours.end());
+    }
+  }
+}
+
+void nodeOrder::byRcm(const graphT& graph)
+{
+  std::vector<nodeIdT> starts(graph.getNumNodes());
+  iota(starts.begin(), starts.end(), 0);
+  stable_sort(starts.begin(), starts.end(),
+              [&](const nodeIdT a, const nodeIdT b) {
+                return graph.outDegree(a) < graph.outDegree(b);
+              });
+  traverse(graph, starts, true);
+  reverse(oldIds.begin(), oldIds.end());
+}
+
+void nodeOrder::byDegree(const graphT& graph)
+{
+  oldIds.resize(graph.getNumNodes());
+  iota(oldIds.begin(), oldIds.end(), 0);
+  stable_sort(oldIds.begin(), oldIds.end(),
+              [&](const nodeIdT a, const nodeIdT b) {
+                return graph.outDegree(a) > graph.outDegree(b);
+              });
+}
+
+void nodeOrder::byBfs(const graphT& graph, const nodeIdT sourceNode)
+  noexcept(false)
+{
+  if (sourceNode >= graph.getNumNodes()) {
+    throw invalid_argument{string("Invalid source node '") +
+                             to_string(sourceNode) + "'"};
+  }
+  std::vector<nodeIdT> starts(graph.getNumNodes() + 1);
+  starts[0] = sourceNode;
+  iota(starts.begin() + 1, starts.end(), 0);
+  traverse(graph, starts, false);
+}
+
+}
@@ -0,0 +1,216 @@
+//===----------------------------------------------------------===//
+// Alg module
+//
+// File purpose: ~relaxKernel~ class implementation. See header file
+// for more detail
+//===----------------------------------------------------------===//
+
+#include "Alg/relaxKernel.hpp"
+#include "Utils/atomicOps.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ALG_RELAXKERNEL_X86 1
+#else
+#define ALG_RELAXKERNEL_X86 0
+#endif
+
+using namespace Utils;
+
+namespace Alg {
+
+template <typename distT>
+constexpr unsigned relaxKernel<distT>::kblockSz;
+template <typename distT>
+constexpr unsigned relaxKernel<distT>::kminEdges;
+template <typename distT>
+constexpr unsigned relaxKernel<distT>::kmaxLanes;
+template <typename distT>
+constexpr unsigned relaxKernel<distT>::kmaxNodes;
+
+// Other threads may be lowering ~dists~, so it is read atomically
+// here; what the vector gathers read may be just as stale, which is
+// fine, as relaxing an edge checks the distance again.
+template <typename distT>
+static inline unsigned filterScalar(const nodeIdT* targets,
+                                    const weightT* weights,
+                                    const unsigned numEdges,
+                                    const distT srcDist, const distT* dists,
+                                    nodeIdT* outTargets, weightT* outWeights)
+{
+  unsigned numOut = 0;
+  for (unsigned i = 0; i < numEdges; ++i) {
+    if (srcDist + weights[i] < atomicOps<distT>::load(&dists[targets[i]])) {
+      outTargets[numOut] = targets[i];
+      outWeights[numOut] = weights[i];
+      ++numOut;
+    }
+  }
+  return numOut;
+}
+
+#if ALG_RELAXKERNEL_X86
+
+// Writes out the lanes set in ~mask~, of the edges from ~first~ on.
+static inline unsigned appendLanes(unsigned mask, const unsigned first,
+                                   const nodeIdT* targets,
+                                   const weightT* weights,
+                                   nodeIdT* outTargets, weightT* outWeights)
+{
+  unsigned numOut = 0;
+  while (mask != 0) {
+    const unsigned i = first + __builtin_ctz(mask);
+    outTargets[numOut] = targets[i];
+    outWeights[numOut] = weights[i];
+    ++numOut;
+    mask &= mask - 1;
+  }
+  return numOut;
+}
+
+// AVX2 only compares signed integers, so both sides have their sign
+// bit flipped first, which orders them as unsigned ones.
+__attribute__((target("avx2")))
+static unsigned filterAvx2(const nodeIdT* targets, const weightT* weights,
+                           const unsigned numEdges, const uint32_t srcDist,
+                           const uint32_t* dists, nodeIdT* outTargets,
+                           weightT* outWeights)
+{
+  const __m256i src = _mm256_set1_epi32(static_cast<int>(srcDist));
+  const __m256i sign = _mm256_set1_epi32(INT32_MIN);
+  unsigned numOut = 0;
+  unsigned i = 0;
+  for (; i + 8 <= numEdges; i += 8) {
+    const __m256i t =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(targets + i));
+    const __m256i w =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+    const __m256i newDists = _mm256_add_epi32(src, w);
+    const __m256i curDists =
+      _mm256_i32gather_epi32(reinterpret_cast<const int*>(dists), t, 4);
+    const __m256i isLower =
+      _mm256_cmpgt_epi32(_mm256_xor_si256(curDists, sign),
+                         _mm256_xor_si256(newDists, sign));
+    const unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(isLower));
+    numOut += appendLanes(mask, i, targets, weights, outTargets + numOut,
+                          outWeights + numOut);
+  }
+  return numOut + filterScalar(targets + i, weights + i, numEdges - i,
+                               srcDist, dists, outTargets + numOut,
+                               outWeights + numOut);
+}
+
+__attribute__((target("avx2")))
+static unsigned filterAvx2(const nodeIdT* targets, const weightT* weights,
+                           const unsigned numEdges, const uint64_t srcDist,
+                           const uint64_t* dists, nodeIdT* outTargets,
+                           weightT* outWeights)
+{
+  const __m256i src = _mm256_set1_epi64x(static_cast<long long>(srcDist));
+  const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+  unsigned numOut = 0;
+  unsigned i = 0;
+  for (; i + 4 <= numEdges; i += 4) {
+    const __m128i t =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(targets + i));
+    const __m256i w = _mm256_cvtepu32_epi64(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i)));
+    const __m256i newDists = _mm256_add_epi64(src, w);
+    const __m256i curDists =
+      _mm256_i32gather_epi64(reinterpret_cast<const long long*>(dists), t, 8);
+    const __m256i isLower =
+      _mm256_cmpgt_epi64(_mm256_xor_si256(curDists, sign),
+                         _mm256_xor_si256(newDists, sign));
+    const unsigned mask = _mm256_movemask_pd(_mm256_castsi256_pd(isLower));
+    numOut += appendLanes(mask, i, targets, weights, outTargets + numOut,
+                          outWeights + numOut);
+  }
+  return numOut + filterScalar(targets + i, weights + i, numEdges - i,
+                               srcDist, dists, outTargets + numOut,
+                               outWeights + numOut);
+}
+
+// Masked loads and gathers do not touch the lanes past the last edge,
+// so there is no scalar tail. The kept lanes are compressed within a
+// register and stored whole, which is faster than compressing to
+// memory on some CPUs; the lanes after them land in the room the
+// outputs have to spare.
+__attribute__((target("avx512f")))
+static unsigned filterAvx512(const nodeIdT* targets, const weightT* weights,
+                             const unsigned numEdges, const uint32_t srcDist,
+                             const uint32_t* dists, nodeIdT* outTargets,
+                             weightT* outWeights)
+{
+  const __m512i src = _mm512_set1_epi32(static_cast<int>(srcDist));
+  unsigned numOut = 0;
+  for (unsigned i = 0; i < numEdges; i += 16) {
+    const __mmask16 lanes = numEdges - i >= 16
+      ? 0xFFFF : static_cast<__mmask16>((1u << (numEdges - i)) - 1);
+    const __m512i t = _mm512_maskz_loadu_epi32(lanes, targets + i);
+    const __m512i w = _mm512_maskz_loadu_epi32(lanes, weights + i);
+    const __m512i newDists = _mm512_add_epi32(src, w);
+    const __m512i curDists =
+      _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), lanes, t, dists, 4);
+    const __mmask16 isLower =
+      _mm512_mask_cmplt_epu32_mask(lanes, newDists, curDists);
+    _mm512_storeu_si512(outTargets + numOut,
+                        _mm512_maskz_compress_epi32(isLower, t));
+    _mm512_storeu_si512(outWeights + numOut,
+                        _mm512_maskz_compress_epi32(isLower, w));
+    numOut += __builtin_popcount(isLower);
+  }
+  return numOut;
+}
+
+__attribute__((target("avx512f")))
+static unsigned filterAvx512(const nodeIdT* targets, const weightT* weights,
+                             const unsigned numEdges, const uint64_t srcDist,
+                             const uint64_t* dists, nodeIdT* outTargets,
+                             weightT* outWeights)
+{
+  const __m512i src = _mm512_set1_epi64(static_cast<long long>(srcDist));
+  unsigned numOut = 0;
+  for (unsigned i = 0; i < numEdges; i += 8) {
+    const __mmask8 lanes = numEdges - i >= 8
+      ? 0xFF : static_cast<__mmask8>((1u << (numEdges - i)) - 1);
+    const __m512i t = _mm512_maskz_loadu_epi32(lanes, targets + i);
+    const __m512i w = _mm512_maskz_loadu_epi32(lanes, weights + i);
+    const __m512i newDists =
+      _mm512_add_epi64(src, _mm512_cvtepu32_epi64(_mm512_castsi512_si256(w)));
+    const __m512i curDists =
+      _mm512_mask_i32gather_epi64(_mm512_setzero_si512(), lanes,
+                                  _mm512_castsi512_si256(t), dists, 8);
+    const __mmask8 isLower =
+      _mm512_mask_cmplt_epu64_mask(lanes, newDists, curDists);
+    _mm512_storeu_si512(outTargets + numOut,
+                        _mm512_maskz_compress_epi32(isLower, t));
+    _mm512_storeu_si512(outWeights + numOut,
+                        _mm512_maskz_compress_epi32(isLower, w));
+    numOut += __builtin_popcount(isLower);
+  }
+  return numOut;
+}
+
+#endif
+
+template <typename distT>
+typename relaxKernel<distT>::filterT relaxKernel<distT>::select()
+{
+#if ALG_RELAXKERNEL_X86
+  if (ALG_DELTASTEPPING_SIMD) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+      return filterAvx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      return filterAvx2;
+    }
+  }
+#endif
+  return nullptr;
+}
+
+template class relaxKernel<uint32_t>;
+template class relaxKernel<uint64_t>;
+
+}
@@ -0,0 +1,393 @@
+//===----------------------------------------------------------===//
+// Interface module
+//
+// File purpose: benchmark class implementation. See class header
+// for more detail.
+//===----------------------------------------------------------===//
+
+#include "Interface/benchmark.hpp"
+#include "Alg/deltaSelector.hpp"
+#include "Interface/edgeListReader.hpp"
+#include "Interface/graphSnapshot.hpp"
+#include "Utils/error.hpp"
+#include "Utils/time.hpp"
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+#include <unistd.h>
+#include <sys/utsname.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+using namespace Utils;
+
+namespace Interface {
+
+using graphT = DS::csrGraph;
+
+benchmark::benchmark(const sweep& inSweep) noexcept(false)
+  : swp(inSweep)
+{
+  if (swp.graphs.empty() || swp.modes.empty() || swp.deltas.empty() ||
+      swp.threads.empty()) {
+    throw invalid_argument{"(benchmark) the sweep needs at least one graph,"\
+                             " mode, delta and thread count"};
+  }
+  if (swp.numReps == 0) {
+    throw invalid_argument{"(benchmark) at least one repetition is needed"};
+  }
+  for (const unsigned numThreads : swp.threads) {
+    if (numThreads == 0) {
+      throw invalid_argument{"(benchmark) invalid number of threads '0'"};
+    }
+  }
+  for (const string& deltaArg : swp.deltas) {
+    if (Alg::deltaSelector::parseMode(deltaArg.c_str()) !=
+        Alg::deltaSelector::mode::fixed) {
+      continue;
+    }
+    istringstream iss(deltaArg);
+    float delta = 0;
+    iss >> delta;
+    if (iss.fail() || !iss.eof() || delta < 1) {
+      throw invalid_argument{string("(benchmark) invalid delta '") +
+                               deltaArg + "'"};
+    }
+  }
+}
+
+benchmark::format benchmark::parseFormat(const std::string& arg)
+  noexcept(false)
+{
+  if (arg == kcsvArg) {
+    return format::csv;
+  }
+  if (arg == kjsonArg) {
+    return format::json;
+  }
+  throw invalid_argument{string("Unknown report format '") + arg + "'"};
+}
+
+// A graph is loaded again for every thread count, as loading is done
+// in parallel too.
+void benchmark::run(std::ostream& os, const format reportFormat)
+  noexcept(false)
+{
+  results.clear();
+  for (const string& graphName : swp.graphs) {
+    for (const unsigned numThreads : swp.threads) {
+      std::chrono::duration<double> loadTime;
+      unique_ptr<graphT> graph;
+      TIME_EXECUTION(loadTime, graph.reset(loadGraph(graphName, numThreads)));
+      for (const string& mode : swp.modes) {
+        const size_t numDeltas = isDijkstraMode(mode) ? 1 : swp.deltas.size();
+        for (size_t i = 0; i < numDeltas; ++i) {
+          result res;
+          res.graph = graphName;
+          res.numNodes = graph->getNumNodes();
+          res.numEdges = graph->getNumEdges();
+          res.mode = mode;
+          res.deltaArg = isDijkstraMode(mode) ? "-" : swp.deltas[i];
+          res.delta = 1;
+          res.numThreads = numThreads;
+          res.loadTime = loadTime.count();
+          runCase(graph.get(), res);
+          cerr << graphName << ' ' << mode << " delta " << res.deltaArg
+               << " threads " << numThreads << ": solve median "
+               << res.solve.median << " s\n";
+          results.push_back(res);
+        }
+      }
+    }
+  }
+
+  switch (reportFormat) {
+  case format::csv:
+    writeCsv(os);
+    break;
+  case format::json:
+    writeJson(os);
+    break;
+  }
+  if (os.fail()) {
+    throw runtime_error{"(benchmark) error writing the report"};
+  }
+}
+
+// Same as ~init::readEdges~.
+graphT* benchmark::loadGraph(const std::string& fileName,
+                             const unsigned numThreads) noexcept(false)
+{
+  if (graphSnapshot::isSnapshot(fileName)) {
+    return graphSnapshot::load(fileName, INTERFACE_INIT_VERIFY_SNAPSHOT);
+  }
+  edgeListReader reader(fileName, numThreads);
+  return reader.read();
+}
+
+bool benchmark::isDijkstraMode(const std::string& mode)
+{
+  const string suffix = "dijkstra";
+  return mode.size() >= suffix.size() &&
+    mode.compare(mode.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// The split of the edges is cleared before every repetition, so that
+// preprocessing is really done each time.
+void benchmark::runCase(graphT* graph, result& res) noexcept(false)
+{
+  const Alg::deltaSelector::mode deltaMode =
+    Alg::deltaSelector::parseMode(res.deltaArg.c_str());
+  if (deltaMode == Alg::deltaSelector::mode::fixed && res.deltaArg != "-") {
+    istringstream iss(res.deltaArg);
+    iss >> res.delta;
+  }
+  if (Alg::needsWideDists(*graph)) {
+    runReps<Alg::wideDeltaStepping>(graph, res, deltaMode);
+  }
+  else {
+    runReps<Alg::deltaStepping>(graph, res, deltaMode);
+  }
+}
+
+template <typename dsRunT>
+void benchmark::runReps(graphT* graph, result& res,
+                        const Alg::deltaSelector::mode deltaMode)
+  noexcept(false)
+{
+  dsRunT dsRun;
+  distWriter writer(swp.outFormat, res.numThreads);
+  vector<double> preprocessTimes;
+  vector<double> solveTimes;
+  vector<double> outputTimes;
+  for (unsigned rep = 0; rep < swp.numWarmups + swp.numReps; ++rep) {
+    std::chrono::duration<double> preprocessTime;
+    std::chrono::duration<double> solveTime;
+    std::chrono::duration<double> outputTime{0};
+
+    auto time1 = std::chrono::high_resolution_clock::now();
+    if (deltaMode != Alg::deltaSelector::mode::fixed) {
+      Alg::deltaSelector selector(*graph, swp.sourceNode, res.numThreads);
+      res.delta = max(selector.select(deltaMode).delta, 1.0f);
+    }
+    graph->clearSplit();
+    Alg::deltaStepping::prepareGraph(graph, res.delta, res.numThreads);
+    preprocessTime = std::chrono::high_resolution_clock::now() - time1;
+
+    TIME_EXECUTION(solveTime, (dsRun.run(graph, res.mode.c_str(), res.delta,
+                                         res.numThreads, swp.sourceNode,
+                                         swp.targetNode)));
+
+    if (swp.outFormat != distWriter::format::none) {
+      ofstream ofs(swp.outFileName, ios_base::out | ios_base::trunc |
+                     ios_base::binary);
+      TIME_EXECUTION(outputTime, (writer.write(dsRun, ofs), ofs.flush()));
+    }
+
+    if (rep >= swp.numWarmups) {
+      preprocessTimes.push_back(preprocessTime.count());
+      solveTimes.push_back(solveTime.count());
+      outputTimes.push_back(outputTime.count());
+    }
+  }
+  res.preprocess = summarize(preprocessTimes);
+  res.solve = summarize(solveTimes);
+  res.output = summarize(outputTimes);
+  res.runStats = dsRun.getStats();
+}
+
+// Percentiles are taken by nearest rank, so they are always one of
+// the samples.
+benchmark::stats benchmark::summarize(std::vector<double>& samples)
+{
+  sort(samples.begin(), samples.end());
+  const size_t n = samples.size();
+  stats st;
+  st.min = samples.front();
+  st.max = samples.back();
+  st.median = n % 2 == 1 ? samples[n / 2]
+                         : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+  const size_t p90Rank = static_cast<size_t>(ceil(0.9 * n));
+  st.p90 = samples[p90Rank == 0 ? 0 : p90Rank - 1];
+  double sum = 0;
+  for (const double sample : samples) {
+    sum += sample;
+  }
+  st.mean = sum / n;
+  return st;
+}
+
+void benchmark::writeCsv(std::ostream& os) const
+{
+  for (const auto& info : machineInfo()) {
+    os << "# " << info.first << ": " << info.second << '\n';
+  }
+  const char* const phases[] = {"preprocess", "solve", "output"};
+  const char* const statNames[] = {"min", "median", "p90", "max", "mean"};
+  os << "graph,nodes,edges,mode,delta_arg,delta,threads,reps,warmups,load_s";
+  for (const char* phase : phases) {
+    for (const char* statName : statNames) {
+      os << ',' << phase << '_' << statName << "_s";
+    }
+  }
+  if (ALG_DELTASTEPPING_STATS) {
+    os << ",buckets,phases,dense_phases,reinsertions,relax_attempts,"\
+      "relax_successes,fusion_iters,barrier_s,merge_s";
+  }
+  os << '\n';
+
+  os << setprecision(6) << std::fixed;
+  for (const result& res : results) {
+    // Graph names are the only field that may hold a comma.
+    string graph = res.graph;
+    for (size_t pos = graph.find('"'); pos != string::npos;
+         pos = graph.find('"', pos + 2)) {
+      graph.insert(pos, 1, '"');
+    }
+    os << '"' << graph << "\"," << res.numNodes << ',' << res.numEdges
+       << ',' << res.mode << ',' << res.deltaArg << ','
+       << deltaString(res.delta) << ','
+       << res.numThreads << ',' << swp.numReps << ',' << swp.numWarmups
+       << ',' << res.loadTime;
+    for (const stats* st : {&res.preprocess, &res.solve, &res.output}) {
+      os << ',' << st->min << ',' << st->median << ',' << st->p90 << ','
+         << st->max << ',' << st->mean;
+    }
+    if (ALG_DELTASTEPPING_STATS) {
+      const Alg::runStats& rs = res.runStats;
+      os << ',' << rs.numBuckets << ',' << rs.numPhases << ','
+         << rs.numDensePhases << ',' << rs.numReinsertions << ',' << rs.numRelaxAttempts << ','
+         << rs.numRelaxSuccesses << ',' << rs.numFusionIters << ','
+         << rs.barrierTime << ',' << rs.mergeTime;
+    }
+    os << '\n';
+  }
+}
+
+void benchmark::writeJson(std::ostream& os) const
+{
+  os << "{\n  \"machine\": {";
+  const auto info = machineInfo();
+  for (size_t i = 0; i < info.size(); ++i) {
+    os << (i == 0 ? "\n" : ",\n") << "    " << jsonString(info[i].first)
+       << ": " << jsonString(info[i].second);
+  }
+  os << "\n  },\n  \"reps\": " << swp.numReps
+     << ",\n  \"warmups\": " << swp.numWarmups << ",\n  \"results\": [";
+
+  os << setprecision(6) << std::fixed;
+  for (size_t i = 0; i < results.size(); ++i) {
+    const result& res = results[i];
+    os << (i == 0 ? "\n" : ",\n") << "    {\"graph\": "
+       << jsonString(res.graph) << ", \"nodes\": " << res.numNodes
+       << ", \"edges\": " << res.numEdges << ", \"mode\": "
+       << jsonString(res.mode) << ", \"delta_arg\": "
+       << jsonString(res.deltaArg) << ", \"delta\": "
+       << deltaString(res.delta) << ", \"threads\": "
+       << res.numThreads << ", \"load_s\": " << res.loadTime;
+    const char* const phases[] = {"preprocess", "solve", "output"};
+    const stats* phaseStats[] = {&res.preprocess, &res.solve, &res.output};
+    for (unsigned p = 0; p < 3; ++p) {
+      const stats& st = *phaseStats[p];
+      os << ", \"" << phases[p] << "_s\": {\"min\": " << st.min
+         << ", \"median\": " << st.median << ", \"p90\": " << st.p90
+         << ", \"max\": " << st.max << ", \"mean\": " << st.mean << '}';
+    }
+    if (ALG_DELTASTEPPING_STATS) {
+      const Alg::runStats& rs = res.runStats;
+      os << ", \"stats\": {\"buckets\": " << rs.numBuckets
+         << ", \"phases\": " << rs.numPhases << ", \"dense_phases\": "
+         << rs.numDensePhases << ", \"reinsertions\": "
+         << rs.numReinsertions << ", \"relax_attempts\": "
+         << rs.numRelaxAttempts << ", \"relax_successes\": "
+         << rs.numRelaxSuccesses << ", \"fusion_iters\": "
+         << rs.numFusionIters << ", \"barrier_s\": " << rs.barrierTime
+         << ", \"merge_s\": " << rs.mergeTime << '}';
+    }
+    os << '}';
+  }
+  os << "\n  ]\n}\n";
+}
+
+std::vector<std::pair<std::string, std::string> > benchmark::machineInfo()
+{
+  vector<pair<string, string> > info;
+
+  char date[32];
+  const time_t now = std::time(nullptr);
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+  info.emplace_back("date", date);
+
+  char host[256] = "";
+  gethostname(host, sizeof(host) - 1);
+  info.emplace_back("host", host);
+
+  struct utsname uts;
+  if (uname(&uts) == 0) {
+    info.emplace_back("os", string(uts.sysname) + ' ' + uts.release + ' ' +
+                        uts.machine);
+  }
+
+  ifstream cpuinfo("/proc/cpuinfo");
+  string line;
+  while (getline(cpuinfo, line)) {
+    if (line.compare(0, 10, "model name") == 0) {
+      const size_t colonPos = line.find(':');
+      if (colonPos != string::npos) {
+        info.emplace_back("cpu", line.substr(line.find_first_not_of(
+                                               " \t", colonPos + 1)));
+      }
+      break;
+    }
+  }
+
+#ifdef _OPENMP
+  info.emplace_back("logical_cpus", to_string(omp_get_num_procs()));
+  info.emplace_back("omp_max_threads", to_string(omp_get_max_threads()));
+  info.emplace_back("openmp", to_string(_OPENMP));
+#endif
+  info.emplace_back("compiler", __VERSION__);
+  return info;
+}
+
+std::string benchmark::jsonString(const std::string& s)
+{
+  string quoted = "\"";
+  for (const char c : s) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+      quoted += c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      quoted += escaped;
+    }
+    else {
+      quoted += c;
+    }
+  }
+  return quoted + '"';
+}
+
+std::string benchmark::deltaString(const float delta)
+{
+  ostringstream oss;
+  oss << setprecision(numeric_limits<float>::max_digits10) << delta;
+  return oss.str();
+}
+
+}
@@ -0,0 +1,200 @@
+//===----------------------------------------------------------===//
+// Interface module
+//
+// File purpose: distWriter class implementation. See class header
+// for more detail.
+//===----------------------------------------------------------===//
+
+#include "Interface/distWriter.hpp"
+#include "Utils/error.hpp"
+#include "Utils/str.hpp"
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+using namespace Utils;
+
+namespace Interface {
+
+constexpr char distWriter::kmagic[8];
+
+distWriter::distWriter(const format outFormat, const unsigned numThreads)
+  : outFormat(outFormat), numThreads(numThreads == 0 ? 1 : numThreads)
+{}
+
+distWriter::format distWriter::parseFormat(const std::string& arg)
+  noexcept(false)
+{
+  if (arg == knoneArg) {
+    return format::none;
+  }
+  if (arg == ktextArg) {
+    return format::text;
+  }
+  if (arg == kbinaryArg) {
+    return format::binary;
+  }
+  throw invalid_argument{string("Unknown output format '") + arg + "'"};
+}
+
+distWriter::format distWriter::getFormat() const
+{
+  return outFormat;
+}
+
+template <typename distT>
+void distWriter::write(Alg::basicDeltaStepping<distT>& dsRun,
+                       std::ostream& os) noexcept(false)
+{
+  switch (outFormat) {
+  case format::none:
+    return;
+  case format::text:
+    writeText(dsRun, os);
+    break;
+  case format::binary:
+    writeBinary(dsRun, os);
+    break;
+  }
+  checkStream(os);
+}
+
+// Runs with a target only write a line or two, which is left to the
+// algorithm itself.
+template <typename distT>
+void distWriter::writeText(Alg::basicDeltaStepping<distT>& dsRun,
+                           std::ostream& os)
+{
+  if (dsRun.getTargetNode() != Alg::deltaStepping::knoTarget) {
+    dsRun.printOutToStream(os);
+    return;
+  }
+  const typename Alg::basicDeltaStepping<distT>::distsT& dists =
+    dsRun.getDists();
+  const bool hasPreds = dsRun.getIsTrackingPaths();
+  const nodeIdT* preds = hasPreds ? dsRun.getPreds().data() : nullptr;
+  const unsigned numNodes = static_cast<unsigned>(dists.size());
+  const unsigned numChunks = (numNodes + kchunkNodes - 1) / kchunkNodes;
+  #pragma omp parallel num_threads(numThreads)
+  {
+    std::vector<char> buf(static_cast<size_t>(kchunkNodes) * kmaxLineLen);
+    #pragma omp for ordered schedule(dynamic, 1)
+    for (unsigned c = 0; c < numChunks; ++c) {
+      const unsigned first = c * kchunkNodes;
+      const unsigned last = numNodes - first < kchunkNodes
+        ? numNodes : first + kchunkNodes;
+      char* p = buf.data();
+      for (unsigned i = first; i < last; ++i) {
+        p = str::appendUns(p, i);
+        *p++ = ' ';
+        p = str::appendUns(
+          p, Alg::basicDeltaStepping<distT>::toOutDist(dists[i]));
+        if (hasPreds) {
+          *p++ = ' ';
+          p = str::appendUns(p, preds[i]);
+        }
+        *p++ = '\n';
+      }
+      #pragma omp ordered
+      os.write(buf.data(), p - buf.data());
+    }
+  }
+}
+
+// The reached nodes are packed in two passes over the words of the
+// bitmap: one to count them, and one to place them after the ones of
+// all earlier words.
+template <typename distT>
+void distWriter::writeBinary(Alg::basicDeltaStepping<distT>& dsRun,
+                             std::ostream& os)
+{
+  const typename Alg::basicDeltaStepping<distT>::distsT& dists =
+    dsRun.getDists();
+  const bool hasPreds = dsRun.getIsTrackingPaths();
+  const nodeIdT* preds = hasPreds ? dsRun.getPreds().data() : nullptr;
+  const nodeIdT targetNode = dsRun.getTargetNode();
+  const unsigned numNodes = static_cast<unsigned>(dists.size());
+  const unsigned numWords = (numNodes + 63) / 64;
+  const distT infDist = numeric_limits<distT>::max();
+
+  std::vector<uint64_t> reached(numWords, 0);
+  std::vector<uint64_t> wordBegin(numWords + 1, 0);
+  if (targetNode != Alg::deltaStepping::knoTarget) {
+    if (dists[targetNode] != infDist) {
+      reached[targetNode / 64] = uint64_t(1) << (targetNode % 64);
+    }
+  }
+  else {
+    #pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (unsigned w = 0; w < numWords; ++w) {
+      const unsigned first = w * 64;
+      const unsigned last = numNodes - first < 64 ? numNodes : first + 64;
+      uint64_t word = 0;
+      for (unsigned i = first; i < last; ++i) {
+        if (dists[i] != infDist) {
+          word |= uint64_t(1) << (i - first);
+        }
+      }
+      reached[w] = word;
+    }
+  }
+  for (unsigned w = 0; w < numWords; ++w) {
+    wordBegin[w + 1] = wordBegin[w] + __builtin_popcountll(reached[w]);
+  }
+  const uint64_t numReached = wordBegin[numWords];
+
+  std::vector<distT> reachedDists(numReached);
+  std::vector<nodeIdT> reachedPreds(hasPreds ? numReached : 0);
+  #pragma omp parallel for num_threads(numThreads) schedule(static)
+  for (unsigned w = 0; w < numWords; ++w) {
+    uint64_t pos = wordBegin[w];
+    for (uint64_t word = reached[w]; word != 0; word &= word - 1) {
+      const unsigned i = w * 64 + __builtin_ctzll(word);
+      reachedDists[pos] = dists[i];
+      if (hasPreds) {
+        reachedPreds[pos] = preds[i];
+      }
+      ++pos;
+    }
+  }
+
+  header hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, kmagic, sizeof(kmagic));
+  hdr.version = kversion;
+  hdr.byteOrderMark = kbyteOrderMark;
+  hdr.nodeIdSz = sizeof(nodeIdT);
+  hdr.distSz = sizeof(distT);
+  hdr.hasPreds = hasPreds ? 1 : 0;
+  hdr.numNodes = numNodes;
+  hdr.numReached = numReached;
+  hdr.sourceNode = dsRun.getSourceNode();
+  hdr.targetNode = targetNode == Alg::deltaStepping::knoTarget
+    ? numeric_limits<uint64_t>::max() : targetNode;
+
+  os.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+  os.write(reinterpret_cast<const char*>(reached.data()),
+           reached.size() * sizeof(uint64_t));
+  os.write(reinterpret_cast<const char*>(reachedDists.data()),
+           reachedDists.size() * sizeof(distT));
+  os.write(reinterpret_cast<const char*>(reachedPreds.data()),
+           reachedPreds.size() * sizeof(nodeIdT));
+}
+
+void distWriter::checkStream(const std::ostream& os) noexcept(false)
+{
+  if (os.fail()) {
+    throw runtime_error{"(distWriter) error writing the distances"};
+  }
+}
+
+template void distWriter::write(Alg::deltaStepping&, std::ostream&);
+template void distWriter::write(Alg::wideDeltaStepping&, std::ostream&);
+
+}
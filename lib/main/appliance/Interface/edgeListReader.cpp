@@ -0,0 +1,331 @@
+//===----------------------------------------------------------===//
+// Interface module
+//
+// File purpose: edgeListReader class implementation. See class
+// header for more detail.
+//===----------------------------------------------------------===//
+
+#include "Interface/edgeListReader.hpp"
+#include "Utils/error.hpp"
+#include "Utils/num.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+using namespace Utils;
+using namespace std;
+
+namespace Interface {
+
+namespace {
+
+// Anything above this is out of range for all the fields, so we stop
+// accumulating digits there instead of overflowing.
+constexpr long long ksaturation = 1LL << 40;
+
+inline const char* skipBlanks(const char* p, const char* end)
+{
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+    ++p;
+  }
+  return p;
+}
+
+// Hand-written replacement for ~ifstream >> int~. Returns false if
+// there is no integer at ~p~ (after blanks).
+inline bool scanInt(const char*& p, const char* end, long long& out)
+{
+  p = skipBlanks(p, end);
+  bool isNegative = false;
+  if (p < end && *p == '-') {
+    isNegative = true;
+    ++p;
+  }
+  if (p == end || *p < '0' || *p > '9') {
+    return false;
+  }
+  long long val = 0;
+  do {
+    if (val < ksaturation) {
+      val = val * 10 + (*p - '0');
+    }
+    ++p;
+  } while (p < end && *p >= '0' && *p <= '9');
+  out = isNegative ? -val : val;
+  return true;
+}
+
+[[noreturn]] void malformedLine(const char* lineBegin, const char* end)
+{
+  const char* lineEnd = find(lineBegin, end, '\n');
+  const size_t kmaxShownLen = 0x40;
+  const size_t len = min(static_cast<size_t>(lineEnd - lineBegin),
+                         kmaxShownLen);
+  throw logic_error{string("(readEdges) malformed edge line '") +
+                      string(lineBegin, len) + "'"};
+}
+
+// Calls ~f(node1, node2, weight)~ for every edge line in
+// [~p~, ~end~). Node IDs are already shifted to start from 0.
+template <class edgeFunT>
+void parseChunk(const char* p, const char* end, edgeFunT f)
+{
+  while (p < end) {
+    p = skipBlanks(p, end);
+    if (p == end) {
+      break;
+    }
+    if (*p == '\n') { // Blank line
+      ++p;
+      continue;
+    }
+
+    const char* lineBegin = p;
+    long long node1 = 0;
+    long long node2 = 0;
+    long long weight = 0;
+    if (!scanInt(p, end, node1) || !scanInt(p, end, node2) ||
+        !scanInt(p, end, weight)) {
+      malformedLine(lineBegin, end);
+    }
+    p = skipBlanks(p, end);
+    if (p < end && *p != '\n') {
+      malformedLine(lineBegin, end);
+    }
+
+    // Check if inputs are in the right range
+    num<long long>::checkInRange(node1, 1, edgeListReader::kmaxNodeId - 1);
+    num<long long>::checkInRange(node2, 1, edgeListReader::kmaxNodeId - 1);
+    num<long long>::checkInRange(weight, 0, edgeListReader::kmaxWeight - 1);
+
+    // Files come with IDs starting from 1, but we want them starting
+    // from 0. This makes everything easier, later on.
+    f(static_cast<nodeIdT>(node1 - 1), static_cast<nodeIdT>(node2 - 1),
+      static_cast<weightT>(weight));
+  }
+}
+
+// Runs ~pass(chunkIdx)~ for every chunk in parallel. Exceptions
+// cannot leave an OpenMP region, so they are carried out of it and
+// the first one is rethrown.
+template <class passT>
+void forEachChunk(const unsigned numChunks, const unsigned numThreads,
+                  passT pass)
+{
+  vector<exception_ptr> errors(numChunks);
+  #pragma omp parallel for num_threads(numThreads) schedule(dynamic, 1)
+  for (unsigned i = 0; i < numChunks; ++i) {
+    try {
+      pass(i);
+    }
+    catch (...) {
+      errors[i] = current_exception();
+    }
+  }
+  for (auto& error : errors) {
+    if (error) {
+      rethrow_exception(error);
+    }
+  }
+}
+
+}
+
+edgeListReader::edgeListReader(const std::string& inFileName,
+                               const unsigned numThreads) noexcept(false)
+  : inFile(inFileName),
+    numThreads(numThreads),
+    inFileHasHeader(false),
+    hdrRows(0),
+    hdrCols(0),
+    bodyBegin(nullptr)
+{
+  inFile.adviseSequential();
+  ignoreComments();
+  if (inFileHasHeader) {
+    readHeader();
+  }
+  splitChunks();
+}
+
+edgeListReader::graphT* edgeListReader::read() noexcept(false)
+{
+  DEBUG(INTERFACE_INIT_DEBUG, "Start -- readEdges");
+
+  // With a header, the number of rows and columns bounds the node
+  // IDs, so the degrees can be counted in the first pass. Otherwise,
+  // one extra pass finds out how many nodes there are.
+  vector<unsigned> numEdges;
+  unsigned maxNodeId = 0;
+  if (inFileHasHeader) {
+    numEdges.assign(num<unsigned>::max(hdrRows, hdrCols), 0);
+    maxNodeId = countEdges(numEdges);
+  }
+  else {
+    maxNodeId = scanMaxNodeId();
+    numEdges.assign(maxNodeId, 0);
+    countEdges(numEdges);
+  }
+  LOGATT(INTERFACE_INIT_DEBUG, maxNodeId);
+
+  if (maxNodeId == 0) {
+    throw logic_error{"(readEdges) input file has no edges"};
+  }
+
+  // Allocate the whole graph here, with the degrees counted above.
+  // Every edge is then placed directly in its final slot.
+  graphT* graph = new graphT(maxNodeId, numEdges, numThreads);
+  try {
+    graph->setMaxEdgeWeight(placeEdges(*graph, numEdges));
+    graph->sortEdgesByWeight(numThreads);
+  }
+  catch (std::exception&) {
+    delete graph;
+    throw;
+  }
+
+  DEBUG(INTERFACE_INIT_DEBUG, "End -- readEdges");
+  return graph;
+}
+
+void edgeListReader::ignoreComments() noexcept(false)
+{
+  DEBUG(INTERFACE_INIT_DEBUG, "Start -- IgnoreComments");
+
+  const char* p = inFile.data();
+  const char* end = p + inFile.size();
+  while (p < end && *p == '%') {
+    ++p;
+    if (p < end && *p == '%') inFileHasHeader = true;
+    // Ignore line
+    while (p < end && *p++ != '\n');
+  }
+  bodyBegin = p;
+
+  LOGATT(INTERFACE_INIT_DEBUG, inFileHasHeader);
+
+  if (p == end) {
+    throw logic_error{"(ignoreComments) file has no contents."};
+  }
+
+  DEBUG(INTERFACE_INIT_DEBUG, "End -- IgnoreComments");
+}
+
+void edgeListReader::readHeader() noexcept(false)
+{
+  const char* p = bodyBegin;
+  const char* end = inFile.data() + inFile.size();
+  while (p < end && (*p == '\n' || *p == '\r' || *p == ' ' || *p == '\t')) {
+    ++p;
+  }
+
+  long long rows = -1;
+  long long cols = -1;
+  long long entries = -1;
+  if (!scanInt(p, end, rows) || !scanInt(p, end, cols) ||
+      !scanInt(p, end, entries)) {
+    throw logic_error{"(readEdges) header -- unexpected EOF"};
+  }
+  num<long long>::checkInRange(rows, 0, kmaxNodeId - 1);
+  num<long long>::checkInRange(cols, 0, kmaxNodeId - 1);
+  hdrRows = static_cast<unsigned>(rows);
+  hdrCols = static_cast<unsigned>(cols);
+
+  p = find(p, end, '\n');
+  bodyBegin = p == end ? end : p + 1;
+}
+
+// Cuts the body in roughly equal pieces, and then moves every cut
+// forward to just after the next newline, so that no line is split.
+void edgeListReader::splitChunks()
+{
+  const char* end = inFile.data() + inFile.size();
+  const size_t bodySz = static_cast<size_t>(end - bodyBegin);
+  const size_t numChunks =
+    num<size_t>::min(static_cast<size_t>(numThreads) * kchunksPerThread,
+                     bodySz / kminChunkSz + 1);
+
+  chunks.clear();
+  const char* chunkBegin = bodyBegin;
+  for (size_t i = 1; i <= numChunks && chunkBegin < end; ++i) {
+    const char* chunkEnd = end;
+    if (i < numChunks) {
+      chunkEnd = num<const char*>::max(bodyBegin + bodySz / numChunks * i,
+                                       chunkBegin);
+      chunkEnd = find(chunkEnd, end, '\n');
+      if (chunkEnd != end) {
+        ++chunkEnd;
+      }
+    }
+    chunks.push_back(chunk{chunkBegin, chunkEnd});
+    chunkBegin = chunkEnd;
+  }
+  LOGATT(INTERFACE_INIT_DEBUG, chunks.size());
+}
+
+unsigned edgeListReader::scanMaxNodeId() noexcept(false)
+{
+  vector<unsigned> chunkMax(chunks.size(), 0);
+  forEachChunk(chunks.size(), numThreads, [&](const unsigned i) {
+    unsigned maxId = 0;
+    parseChunk(chunks[i].begin, chunks[i].end,
+               [&](nodeIdT node1, nodeIdT node2, weightT) {
+                 maxId = num<unsigned>::max(maxId,
+                                            num<unsigned>::max(node1, node2) + 1);
+               });
+    chunkMax[i] = maxId;
+  });
+  return chunks.empty() ? 0 : *max_element(chunkMax.begin(), chunkMax.end());
+}
+
+// Counts the outgoing edges of each node into ~numEdges~, and
+// returns the number of nodes seen.
+unsigned edgeListReader::countEdges(std::vector<unsigned>& numEdges)
+  noexcept(false)
+{
+  const unsigned numNodesBound = numEdges.size();
+  vector<unsigned> chunkMax(chunks.size(), 0);
+  forEachChunk(chunks.size(), numThreads, [&](const unsigned i) {
+    unsigned maxId = 0;
+    parseChunk(chunks[i].begin, chunks[i].end,
+               [&](nodeIdT node1, nodeIdT node2, weightT) {
+                 const unsigned edgeMaxId = num<unsigned>::max(node1, node2) + 1;
+                 if (edgeMaxId > numNodesBound) {
+                   throw logic_error{
+                     string("(readEdges) node ") + to_string(edgeMaxId) +
+                       " is out of the header dimensions (" +
+                       to_string(hdrRows) + ", " + to_string(hdrCols) + ")"};
+                 }
+                 maxId = num<unsigned>::max(maxId, edgeMaxId);
+                 #pragma omp atomic
+                 numEdges[node1]++;
+               });
+    chunkMax[i] = maxId;
+  });
+  return chunks.empty() ? 0 : *max_element(chunkMax.begin(), chunkMax.end());
+}
+
+// Consumes ~numEdges~: each edge takes the last free slot of its
+// source node. Returns the maximum edge weight.
+weightT edgeListReader::placeEdges(graphT& graph,
+                                   std::vector<unsigned>& numEdges)
+  noexcept(false)
+{
+  vector<weightT> chunkMax(chunks.size(), 0);
+  forEachChunk(chunks.size(), numThreads, [&](const unsigned i) {
+    weightT maxWeight = 0;
+    parseChunk(chunks[i].begin, chunks[i].end,
+               [&](nodeIdT node1, nodeIdT node2, weightT weight) {
+                 unsigned pos;
+                 #pragma omp atomic capture
+                 pos = --numEdges[node1];
+                 graph.insertEdge(node1, node2, weight, pos);
+                 maxWeight = num<weightT>::max(maxWeight, weight);
+               });
+    chunkMax[i] = maxWeight;
+  });
+  return chunks.empty() ? 0 : *max_element(chunkMax.begin(), chunkMax.end());
+}
+
+}
@@ -0,0 +1,347 @@
+//===----------------------------------------------------------===//
+// Interface module
+//
+// File purpose: graphGenerator class implementation. See class
+// header for more detail.
+//===----------------------------------------------------------===//
+
+#include "Interface/graphGenerator.hpp"
+#include "Interface/edgeListReader.hpp"
+#include "Utils/error.hpp"
+#include "Utils/num.hpp"
+#include "Utils/str.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace Utils;
+
+namespace Interface {
+
+namespace {
+
+// Finalizer of splitmix64. Every bit of the input affects every bit
+// of the output.
+inline uint64_t mix(uint64_t z)
+{
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// Uniform in [0, 1)
+inline double toUnit(const uint64_t r)
+{
+  return static_cast<double>(r >> 11) * (1.0 / 9007199254740992.0);
+}
+
+const char* const kkindNames[] = {"uniform", "rmat", "grid"};
+const char* const kweightDistNames[] = {"uniform", "exponential", "constant"};
+
+}
+
+constexpr double graphGenerator::krmatA;
+constexpr double graphGenerator::krmatB;
+constexpr double graphGenerator::krmatC;
+constexpr edgeIdT graphGenerator::kchunkEdges;
+constexpr unsigned graphGenerator::kmaxLineLen;
+constexpr double graphGenerator::kexpDivisor;
+constexpr uint64_t graphGenerator::ksrcStream;
+constexpr uint64_t graphGenerator::kdestStream;
+constexpr uint64_t graphGenerator::kweightStream;
+constexpr uint64_t graphGenerator::krmatStream;
+constexpr uint64_t graphGenerator::knumStreams;
+
+graphGenerator::graphGenerator(const params& inParams,
+                               const unsigned numThreads) noexcept(false)
+  : prm(inParams), numThreads(numThreads == 0 ? 1 : numThreads),
+    numNodes(0), numEdges(0), scale(0), side(0)
+{
+  const unsigned kmaxNumNodes = edgeListReader::kmaxNodeId - 1;
+  if (prm.numNodes == 0 || prm.numNodes > kmaxNumNodes) {
+    throw invalid_argument{string("(graphGenerator) number of nodes must be"\
+                                  " in [1, ") + to_string(kmaxNumNodes) +
+                             "]"};
+  }
+  if (prm.degree == 0) {
+    throw invalid_argument{"(graphGenerator) degree must be at least 1"};
+  }
+  num<weightT>::checkInRange(prm.maxWeight, 1,
+                             edgeListReader::kmaxWeight - 1);
+
+  switch (prm.graphKind) {
+  case kind::uniform:
+    numNodes = prm.numNodes;
+    numEdges = static_cast<edgeIdT>(numNodes) * prm.degree;
+    break;
+  case kind::rmat:
+    while ((uint64_t(1) << scale) < prm.numNodes) {
+      ++scale;
+    }
+    if ((uint64_t(1) << scale) > kmaxNumNodes) {
+      throw invalid_argument{string("(graphGenerator) R-MAT graphs of ") +
+                               to_string(prm.numNodes) + " nodes would have" +
+                               " more than " + to_string(kmaxNumNodes)};
+    }
+    numNodes = 1U << scale;
+    numEdges = static_cast<edgeIdT>(numNodes) * prm.degree;
+    break;
+  case kind::grid:
+    side = static_cast<unsigned>(sqrt(static_cast<double>(prm.numNodes)));
+    while (static_cast<uint64_t>(side + 1) * (side + 1) <= prm.numNodes) {
+      ++side;
+    }
+    while (static_cast<uint64_t>(side) * side > prm.numNodes) {
+      --side;
+    }
+    if (side < 2) {
+      throw invalid_argument{"(graphGenerator) grids need at least 4 nodes"};
+    }
+    numNodes = side * side;
+    numEdges = static_cast<edgeIdT>(numNodes) * 4;
+    break;
+  }
+  LOGATT(INTERFACE_INIT_DEBUG, numNodes);
+  LOGATT(INTERFACE_INIT_DEBUG, numEdges);
+}
+
+graphGenerator::kind graphGenerator::parseKind(const std::string& arg)
+  noexcept(false)
+{
+  for (unsigned i = 0; i < sizeof(kkindNames) / sizeof(*kkindNames); ++i) {
+    if (arg == kkindNames[i]) {
+      return static_cast<kind>(i);
+    }
+  }
+  throw invalid_argument{string("Unknown graph kind '") + arg + "'"};
+}
+
+graphGenerator::weightDist
+graphGenerator::parseWeightDist(const std::string& arg) noexcept(false)
+{
+  for (unsigned i = 0;
+       i < sizeof(kweightDistNames) / sizeof(*kweightDistNames); ++i) {
+    if (arg == kweightDistNames[i]) {
+      return static_cast<weightDist>(i);
+    }
+  }
+  throw invalid_argument{string("Unknown weight distribution '") + arg +
+                           "'"};
+}
+
+const char* graphGenerator::kindName(const kind graphKind)
+{
+  return kkindNames[static_cast<unsigned>(graphKind)];
+}
+
+const char* graphGenerator::weightDistName(const weightDist weights)
+{
+  return kweightDistNames[static_cast<unsigned>(weights)];
+}
+
+unsigned graphGenerator::getNumNodes() const
+{
+  return numNodes;
+}
+
+edgeIdT graphGenerator::getNumEdges() const
+{
+  return numEdges;
+}
+
+// Same two passes as ~edgeListReader~: the degrees are counted first,
+// and then every edge takes a free slot of its source node. The slots
+// are taken in no particular order, but sorting the edges afterwards
+// makes the graph the same every time.
+graphGenerator::graphT* graphGenerator::build() const noexcept(false)
+{
+  DEBUG(INTERFACE_INIT_DEBUG, "Start -- graphGenerator::build");
+  vector<unsigned> degrees(numNodes, 0);
+  #pragma omp parallel for num_threads(numThreads) schedule(dynamic, 1)
+  for (edgeIdT first = 0; first < numEdges; first += kchunkEdges) {
+    const edgeIdT last = num<edgeIdT>::min(first + kchunkEdges, numEdges);
+    for (edgeIdT e = first; e < last; ++e) {
+      nodeIdT src = 0;
+      nodeIdT dest = 0;
+      makeEdge(e, src, dest);
+      #pragma omp atomic
+      degrees[src]++;
+    }
+  }
+
+  graphT* graph = new graphT(numNodes, degrees, numThreads);
+  weightT maxWeight = 0;
+  #pragma omp parallel for num_threads(numThreads) schedule(dynamic, 1) \
+    reduction(max:maxWeight)
+  for (edgeIdT first = 0; first < numEdges; first += kchunkEdges) {
+    const edgeIdT last = num<edgeIdT>::min(first + kchunkEdges, numEdges);
+    for (edgeIdT e = first; e < last; ++e) {
+      nodeIdT src = 0;
+      nodeIdT dest = 0;
+      makeEdge(e, src, dest);
+      const weightT weight = makeWeight(e);
+      unsigned pos;
+      #pragma omp atomic capture
+      pos = --degrees[src];
+      graph->insertEdge(src, dest, weight, pos);
+      maxWeight = num<weightT>::max(maxWeight, weight);
+    }
+  }
+  graph->setMaxEdgeWeight(maxWeight);
+  graph->sortEdgesByWeight(numThreads);
+  DEBUG(INTERFACE_INIT_DEBUG, "End -- graphGenerator::build");
+  return graph;
+}
+
+// The parameters go in a comment under the MatrixMarket banner, so
+// that the file tells how to make it again.
+void graphGenerator::writeText(const std::string& outFileName) const
+  noexcept(false)
+{
+  ofstream ofs(outFileName, ios::binary);
+  if (!ofs) {
+    throw runtime_error{string("(graphGenerator) cannot open '") +
+                          outFileName + "' for writing"};
+  }
+  ofs << "%%MatrixMarket matrix coordinate integer general\n"
+      << "% generated kind=" << kindName(prm.graphKind)
+      << " nodes=" << prm.numNodes << " degree=" << prm.degree
+      << " weights=" << weightDistName(prm.weights)
+      << " max-weight=" << prm.maxWeight << " seed=" << prm.seed << '\n'
+      << numNodes << ' ' << numNodes << ' ' << numEdges << '\n';
+
+  const edgeIdT numChunks = (numEdges + kchunkEdges - 1) / kchunkEdges;
+  #pragma omp parallel num_threads(numThreads)
+  {
+    vector<char> buf(static_cast<size_t>(kchunkEdges) * kmaxLineLen);
+    #pragma omp for ordered schedule(dynamic, 1)
+    for (edgeIdT c = 0; c < numChunks; ++c) {
+      const edgeIdT first = c * kchunkEdges;
+      const edgeIdT last = num<edgeIdT>::min(first + kchunkEdges, numEdges);
+      char* p = buf.data();
+      for (edgeIdT e = first; e < last; ++e) {
+        nodeIdT src = 0;
+        nodeIdT dest = 0;
+        makeEdge(e, src, dest);
+        p = str::appendUns(p, src + 1);
+        *p++ = ' ';
+        p = str::appendUns(p, dest + 1);
+        *p++ = ' ';
+        p = str::appendUns(p, makeWeight(e));
+        *p++ = '\n';
+      }
+      #pragma omp ordered
+      ofs.write(buf.data(), p - buf.data());
+    }
+  }
+  ofs.close();
+  if (ofs.fail()) {
+    throw runtime_error{string("(graphGenerator) error writing '") +
+                          outFileName + "'"};
+  }
+}
+
+void graphGenerator::makeEdge(const edgeIdT edgeId, nodeIdT& src,
+                              nodeIdT& dest) const
+{
+  switch (prm.graphKind) {
+  case kind::uniform:
+    src = static_cast<nodeIdT>(random(edgeId, ksrcStream) % numNodes);
+    dest = static_cast<nodeIdT>(random(edgeId, kdestStream) % numNodes);
+    break;
+  case kind::rmat:
+    makeRmatEdge(edgeId, src, dest);
+    break;
+  case kind::grid: {
+    // Edges 4i to 4i + 3 go from node i to the right, left, lower and
+    // upper neighbours.
+    src = static_cast<nodeIdT>(edgeId / 4);
+    const unsigned row = src / side;
+    const unsigned col = src % side;
+    switch (edgeId % 4) {
+    case 0:
+      dest = row * side + (col + 1 == side ? 0 : col + 1);
+      break;
+    case 1:
+      dest = row * side + (col == 0 ? side - 1 : col - 1);
+      break;
+    case 2:
+      dest = (row + 1 == side ? 0 : row + 1) * side + col;
+      break;
+    default:
+      dest = (row == 0 ? side - 1 : row - 1) * side + col;
+      break;
+    }
+    break;
+  }
+  }
+}
+
+// At each level, the edge goes down into one of the four quadrants of
+// the adjacency matrix, which fixes one more bit of each end.
+void graphGenerator::makeRmatEdge(const edgeIdT edgeId, nodeIdT& src,
+                                  nodeIdT& dest) const
+{
+  nodeIdT row = 0;
+  nodeIdT col = 0;
+  for (unsigned level = 0; level < scale; ++level) {
+    const double u = toUnit(random(edgeId, krmatStream + level));
+    row <<= 1;
+    col <<= 1;
+    if (u < krmatA) {
+      // Top-left
+    }
+    else if (u < krmatA + krmatB) {
+      col |= 1;
+    }
+    else if (u < krmatA + krmatB + krmatC) {
+      row |= 1;
+    }
+    else {
+      row |= 1;
+      col |= 1;
+    }
+  }
+  src = scramble(row);
+  dest = scramble(col);
+}
+
+// A bijection of [0, numNodes): products by odd numbers and xors are
+// all invertible modulo a power of two.
+nodeIdT graphGenerator::scramble(const nodeIdT nodeId) const
+{
+  const uint64_t mask = numNodes - 1;
+  uint64_t x = (nodeId * 0x9E3779B97F4A7C15ULL) & mask;
+  x ^= mix(prm.seed) & mask;
+  x = (x * 0xD6E8FEB86659FD93ULL) & mask;
+  return static_cast<nodeIdT>(x);
+}
+
+weightT graphGenerator::makeWeight(const edgeIdT edgeId) const
+{
+  const uint64_t r = random(edgeId, kweightStream);
+  switch (prm.weights) {
+  case weightDist::uniform:
+    return static_cast<weightT>(1 + r % prm.maxWeight);
+  case weightDist::exponential: {
+    // 1 - u is in (0, 1], so that the logarithm is finite.
+    const double x = -log(1.0 - toUnit(r)) * prm.maxWeight / kexpDivisor;
+    return x >= prm.maxWeight - 1
+      ? prm.maxWeight : static_cast<weightT>(1 + x);
+  }
+  case weightDist::constant:
+    break;
+  }
+  return prm.maxWeight;
+}
+
+uint64_t graphGenerator::random(const edgeIdT edgeId,
+                                const uint64_t stream) const
+{
+  return mix(mix(prm.seed) ^ (edgeId * knumStreams + stream));
+}
+
+}
@@ -0,0 +1,267 @@
+//===----------------------------------------------------------===//
+// Interface module
+//
+// File purpose: graphSnapshot class implementation. See class header
+// for more detail.
+//===----------------------------------------------------------===//
+
+#include "Interface/graphSnapshot.hpp"
+#include "Utils/error.hpp"
+#include "Utils/mappedFile.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+using namespace std;
+
+namespace Interface {
+
+constexpr char graphSnapshot::kmagic[8];
+
+namespace {
+
+// FNV-1a over 8-byte words (bytes for the tail). Words instead of
+// bytes keep verification close to memory bandwidth.
+constexpr uint64_t kfnvOffset = 0xcbf29ce484222325ULL;
+constexpr uint64_t kfnvPrime = 0x100000001b3ULL;
+
+uint64_t mixBytes(uint64_t h, const void* data, const uint64_t sz)
+{
+  const char* p = static_cast<const char*>(data);
+  uint64_t i = 0;
+  for (; i + sizeof(uint64_t) <= sz; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, p + i, sizeof(word));
+    h = (h ^ word) * kfnvPrime;
+  }
+  for (; i < sz; ++i) {
+    h = (h ^ static_cast<unsigned char>(p[i])) * kfnvPrime;
+  }
+  return h;
+}
+
+void writePadding(ofstream& ofs, const uint64_t toPos)
+{
+  static const char zeros[64] = {};
+  uint64_t pos = static_cast<uint64_t>(ofs.tellp());
+  while (pos < toPos) {
+    const uint64_t len = toPos - pos < sizeof(zeros) ? toPos - pos
+                                                      : sizeof(zeros);
+    ofs.write(zeros, len);
+    pos += len;
+  }
+}
+
+}
+
+graphSnapshot::header graphSnapshot::makeHeader(const graphT& graph)
+{
+  header hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, kmagic, sizeof(kmagic));
+  hdr.version = kversion;
+  hdr.byteOrderMark = kbyteOrderMark;
+  hdr.edgeIdSz = sizeof(edgeIdT);
+  hdr.nodeIdSz = sizeof(nodeIdT);
+  hdr.weightSz = sizeof(weightT);
+  hdr.numNodes = graph.getNumNodes();
+  hdr.numEdges = graph.getNumEdges();
+  hdr.maxEdgeWeight = graph.getMaxEdgeWeight();
+  const DS::packedEdges* packed = graph.getPacked();
+  if (packed) {
+    hdr.isPacked = 1;
+    hdr.weightWidth = static_cast<uint8_t>(packed->getWeightWidth());
+    hdr.edgeBytesSz = packed->getBytesSz();
+  }
+  layOut(hdr);
+  return hdr;
+}
+
+void graphSnapshot::layOut(header& hdr)
+{
+  hdr.offsetsPos = alignUp(sizeof(header));
+  hdr.groupsPos =
+    alignUp(hdr.offsetsPos + (hdr.numNodes + 1) * sizeof(edgeIdT));
+  hdr.targetsPos = alignUp(hdr.groupsPos + groupsSz(hdr));
+  hdr.weightsPos = alignUp(hdr.targetsPos + targetsSz(hdr));
+  hdr.fileSz = hdr.weightsPos + weightsSz(hdr);
+}
+
+uint64_t graphSnapshot::groupsSz(const header& hdr)
+{
+  return hdr.isPacked ? DS::packedEdges::numGroupsOf(hdr.numEdges) *
+    sizeof(DS::packedEdges::group) : 0;
+}
+
+uint64_t graphSnapshot::targetsSz(const header& hdr)
+{
+  return hdr.isPacked ? hdr.edgeBytesSz : hdr.numEdges * sizeof(nodeIdT);
+}
+
+uint64_t graphSnapshot::weightsSz(const header& hdr)
+{
+  return hdr.isPacked ? 0 : hdr.numEdges * sizeof(weightT);
+}
+
+void graphSnapshot::write(const graphT& graph, const std::string& outFileName)
+  noexcept(false)
+{
+  DEBUG(INTERFACE_INIT_DEBUG, "Start -- graphSnapshot::write");
+  if (!graph.getIsWeightSorted()) {
+    throw logic_error{"(graphSnapshot) the edges must be sorted by weight"};
+  }
+  header hdr = makeHeader(graph);
+  const DS::packedEdges* packed = graph.getPacked();
+  const char* offsets = reinterpret_cast<const char*>(graph.getOffsets());
+  const char* groups =
+    packed ? reinterpret_cast<const char*>(packed->getGroups()) : nullptr;
+  const char* targets =
+    packed ? reinterpret_cast<const char*>(packed->getBytes())
+           : reinterpret_cast<const char*>(graph.getTargets());
+  const char* weights = reinterpret_cast<const char*>(graph.getWeights());
+  const uint64_t offsetsSz = (hdr.numNodes + 1) * sizeof(edgeIdT);
+
+  uint64_t checksum = kfnvOffset;
+  checksum = mixBytes(checksum, offsets, offsetsSz);
+  checksum = mixBytes(checksum, groups, groupsSz(hdr));
+  checksum = mixBytes(checksum, targets, targetsSz(hdr));
+  checksum = mixBytes(checksum, weights, weightsSz(hdr));
+  hdr.checksum = checksum;
+
+  ofstream ofs(outFileName, ios_base::out | ios_base::trunc |
+                 ios_base::binary);
+  if (!ofs.good()) {
+    throw logic_error{string("(graphSnapshot) cannot open '") +
+                        outFileName + "' for writing"};
+  }
+  ofs.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+  writePadding(ofs, hdr.offsetsPos);
+  ofs.write(offsets, offsetsSz);
+  writePadding(ofs, hdr.groupsPos);
+  ofs.write(groups, groupsSz(hdr));
+  writePadding(ofs, hdr.targetsPos);
+  ofs.write(targets, targetsSz(hdr));
+  writePadding(ofs, hdr.weightsPos);
+  ofs.write(weights, weightsSz(hdr));
+  ofs.close();
+  if (ofs.fail()) {
+    throw logic_error{string("(graphSnapshot) error writing '") +
+                        outFileName + "'"};
+  }
+  DEBUG(INTERFACE_INIT_DEBUG, "End -- graphSnapshot::write");
+}
+
+graphSnapshot::graphT* graphSnapshot::load(const std::string& inFileName,
+                                           bool verifyChecksum)
+  noexcept(false)
+{
+  DEBUG(INTERFACE_INIT_DEBUG, "Start -- graphSnapshot::load");
+  unique_ptr<Utils::mappedFile> inFile{new Utils::mappedFile(inFileName)};
+  if (inFile->size() < sizeof(header)) {
+    throw logic_error{string("(graphSnapshot) '") + inFileName +
+                        "' is too small to be a snapshot"};
+  }
+  header hdr;
+  memcpy(&hdr, inFile->data(), sizeof(hdr));
+  checkHeader(hdr, inFile->size(), inFileName);
+
+  const char* base = inFile->data();
+  auto* offsets = reinterpret_cast<const edgeIdT*>(base + hdr.offsetsPos);
+  auto* groups =
+    reinterpret_cast<const DS::packedEdges::group*>(base + hdr.groupsPos);
+  const char* targets = base + hdr.targetsPos;
+  const char* weights = base + hdr.weightsPos;
+
+  if (offsets[hdr.numNodes] != hdr.numEdges) {
+    throw logic_error{string("(graphSnapshot) '") + inFileName +
+                        "': offsets do not match the number of edges"};
+  }
+
+  if (verifyChecksum) {
+    uint64_t checksum = kfnvOffset;
+    checksum = mixBytes(checksum, offsets,
+                        (hdr.numNodes + 1) * sizeof(edgeIdT));
+    checksum = mixBytes(checksum, groups, groupsSz(hdr));
+    checksum = mixBytes(checksum, targets, targetsSz(hdr));
+    checksum = mixBytes(checksum, weights, weightsSz(hdr));
+    if (checksum != hdr.checksum) {
+      throw logic_error{string("(graphSnapshot) checksum mismatch in '") +
+                          inFileName + "'"};
+    }
+  }
+
+  const unsigned numNodes = static_cast<unsigned>(hdr.numNodes);
+  const weightT maxEdgeWeight = static_cast<weightT>(hdr.maxEdgeWeight);
+  graphT* graph = nullptr;
+  if (hdr.isPacked) {
+    unique_ptr<DS::packedEdges> packed{
+      new DS::packedEdges(hdr.numEdges, hdr.weightWidth, groups,
+                          reinterpret_cast<const unsigned char*>(targets),
+                          hdr.edgeBytesSz)};
+    graph = new graphT(numNodes, hdr.numEdges, maxEdgeWeight, offsets,
+                       std::move(packed), std::move(inFile));
+  }
+  else {
+    graph = new graphT(numNodes, hdr.numEdges, maxEdgeWeight, offsets,
+                       reinterpret_cast<const nodeIdT*>(targets),
+                       reinterpret_cast<const weightT*>(weights),
+                       std::move(inFile));
+  }
+  DEBUG(INTERFACE_INIT_DEBUG, "End -- graphSnapshot::load");
+  return graph;
+}
+
+bool graphSnapshot::isSnapshot(const std::string& fileName) noexcept
+{
+  ifstream ifs(fileName, ios_base::in | ios_base::binary);
+  char magic[sizeof(kmagic)];
+  ifs.read(magic, sizeof(magic));
+  return ifs.good() && memcmp(magic, kmagic, sizeof(kmagic)) == 0;
+}
+
+// Everything that can be checked without touching the arrays.
+void graphSnapshot::checkHeader(const header& hdr, const uint64_t fileSz,
+                                const std::string& fileName) noexcept(false)
+{
+  const string prefix = string("(graphSnapshot) '") + fileName + "': ";
+  if (memcmp(hdr.magic, kmagic, sizeof(kmagic)) != 0) {
+    throw logic_error{prefix + "not a snapshot"};
+  }
+  if (hdr.byteOrderMark != kbyteOrderMark) {
+    throw logic_error{prefix + "written with a different byte order"};
+  }
+  if (hdr.version != kversion) {
+    throw logic_error{prefix + "unsupported version " +
+                        to_string(hdr.version) + " (expected " +
+                        to_string(kversion) + ")"};
+  }
+  if (hdr.edgeIdSz != sizeof(edgeIdT) || hdr.nodeIdSz != sizeof(nodeIdT) ||
+      hdr.weightSz != sizeof(weightT)) {
+    throw logic_error{prefix + "written with different type widths"};
+  }
+  if (hdr.numNodes > numeric_limits<unsigned>::max()) {
+    throw logic_error{prefix + "too many nodes"};
+  }
+  if (hdr.isPacked > 1 ||
+      (hdr.isPacked && (hdr.weightWidth < 1 ||
+                        hdr.weightWidth > sizeof(weightT) ||
+                        hdr.edgeBytesSz < DS::packedEdges::kpadding))) {
+    throw logic_error{prefix + "invalid packing"};
+  }
+
+  // The layout must be the one ~write~ would have produced.
+  graphSnapshot::header expected = hdr;
+  layOut(expected);
+  if (hdr.offsetsPos != expected.offsetsPos ||
+      hdr.groupsPos != expected.groupsPos ||
+      hdr.targetsPos != expected.targetsPos ||
+      hdr.weightsPos != expected.weightsPos ||
+      hdr.fileSz != expected.fileSz || fileSz < hdr.fileSz) {
+    throw logic_error{prefix + "truncated or corrupted layout"};
+  }
+}
+
+}
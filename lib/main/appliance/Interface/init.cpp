@@ -5,7 +5,8 @@
 // more detail.
 //===----------------------------------------------------------===//
 
-#include "DS/wEdge.hpp"
+#include "Interface/edgeListReader.hpp"
+#include "Interface/graphSnapshot.hpp"
 #include "Interface/init.hpp"
 #include "Utils/error.hpp"
 #include "Utils/file.hpp"
@@ -17,13 +18,10 @@
 #include <iostream>
 #include <stdexcept>
 #include <sstream>
-#include <vector>
-
-#include "boost/dynamic_bitset.hpp"
 
 #define INRANGE(n, a, b) (a <= n && n <= b)
 
-using digraph = DS::digraph<nodeIdT>;
+using graphT = DS::csrGraph;
 
 using namespace Utils;
 using namespace std;
@@ -31,13 +29,28 @@ using namespace std;
 namespace Interface {
   
 init::init(int argc, char** argv)
-  : inFileHasHeader(false), inGraph(nullptr), numThreads(1), delta(0.0)
+  : inGraph(nullptr), numThreads(1), delta(0.0),
+    deltaMode(Alg::deltaSelector::mode::fixed), numGroups(1),
+    isTrackingPaths(false), outFormat(distWriter::format::text),
+    orderKind(Alg::nodeOrder::kind::none), isPacking(false)
 {
+  argc = takeOptions(argc, argv);
   const bool isProgArgsValid = validateArguments(argc, argv);
   if (!isProgArgsValid) {
     throw std::invalid_argument {"Invalid program arguments"\
                                    "\nUsage: <program> <in-file>"\
-                                   " <mode> <delta-step> [<num-threads>]"};
+                                   " <mode> <delta-step> [<num-threads>"\
+                                   " [<queries> [<num-groups>]]]"\
+                                   " [--paths] [--output=<format>]"\
+                                   " [--order=<order>] [--compress]"\
+                                   "\n<delta-step> may also be 'auto' or"\
+                                   " 'auto-refine'"\
+                                   "\n<queries> is a file or a comma"\
+                                   " separated list of <source>[:<target>]"\
+                                   "\n<format> is 'text', 'binary' or"\
+                                   " 'none'"\
+                                   "\n<order> is 'none', 'rcm', 'degree'"\
+                                   " or 'bfs'"};
   }
 
   // This loads inGraph
@@ -48,7 +61,12 @@ init::init(int argc, char** argv)
 # endif
   
   try {
-    timeRunAlgo();
+    if (queries.empty()) {
+      timeRunAlgo();
+    }
+    else {
+      timeRunBatch();
+    }
   }
   catch(std::exception&) {
     destroy();
@@ -66,20 +84,116 @@ void init::destroy()
   delete inGraph;
 }
 
+void init::timeRunAlgo()
+{
+  if (Alg::needsWideDists(*inGraph)) {
+    timeRunAlgo<Alg::wideDeltaStepping>();
+  }
+  else {
+    timeRunAlgo<Alg::deltaStepping>();
+  }
+}
+
+template <typename dsRunT>
 void init::timeRunAlgo()
 {
 #if INTERFACE_INIT_PRINT_GRAPH_SIZE
   printGraphSize();
 #endif
-  Alg::deltaStepping dsRun;
+  dsRunT dsRun;
+  dsRun.setIsTrackingPaths(isTrackingPaths);
+  selectDelta(dsRun.getSourceNode());
+  dsRun.setNodeOrder(order.get());
   auto time1 = std::chrono::high_resolution_clock::now();
   dsRun.run(inGraph, inMode.c_str(), delta, static_cast<unsigned>(numThreads));
   clkVar = std::chrono::high_resolution_clock::now() - time1;
 
   writeOut(dsRun);
   printOut(dsRun);
+#if ALG_DELTASTEPPING_STATS
+  dsRun.getStats().print(std::cerr);
+#endif
+}
+
+// The whole batch is timed, including writing the distances out, as
+// each query is written as soon as it is done.
+void init::timeRunBatch()
+{
+#if INTERFACE_INIT_PRINT_GRAPH_SIZE
+  printGraphSize();
+#endif
+  selectDelta(queries.front().source);
+  queryBatch batch(inGraph, inMode, delta, numThreads, numGroups,
+                   isTrackingPaths, outFormat);
+  batch.setNodeOrder(order.get());
+  std::ofstream ofs;
+  if (outFormat != distWriter::format::none) {
+    ofs.open(outFileName, ios_base::out | ios_base::trunc | ios_base::binary);
+  }
+  auto time1 = std::chrono::high_resolution_clock::now();
+  batch.run(queries, ofs);
+  clkVar = std::chrono::high_resolution_clock::now() - time1;
+
+#if INTERFACE_INIT_PRINT_TIME
+  printOutTime();
+#endif
+}
+
+// Choosing delta is not part of the timed run, just like loading the
+// graph is not. The choice goes to stderr, so that it does not mix
+// with the timings.
+void init::selectDelta(const nodeIdT sourceNode)
+{
+  if (deltaMode == Alg::deltaSelector::mode::fixed) {
+    return;
+  }
+  Alg::deltaSelector selector(*inGraph,
+                              order ? order->toNew(sourceNode) : sourceNode,
+                              numThreads);
+  Alg::deltaSelector::choice chosen = selector.select(deltaMode);
+  delta = chosen.delta;
+  if (!INRANGE(delta, kminDelta, kmaxDelta)) {
+    delta = delta < kminDelta ? kminDelta : kmaxDelta;
+  }
+#if INTERFACE_INIT_PRINT_DELTA
+  std::cerr << "Delta: " << delta << " (" << chosen.reason << ")\n";
+#endif
 }
   
+// Options may be anywhere after the program name. The arguments
+// left are moved to the front, in the same order, so that they can
+// be read by position.
+int init::takeOptions(int argc, char** argv) noexcept(false)
+{
+  int numArgs = 0;
+  for (int i = 0; i < argc; ++i) {
+    const string arg{argv[i]};
+    if (i == 0 || arg.compare(0, 2, "--") != 0) {
+      argv[numArgs++] = argv[i];
+    }
+    else if (arg == kpathsOption) {
+      isTrackingPaths = true;
+    }
+    else if (arg == kcompressOption) {
+      isPacking = true;
+    }
+    else if (arg.compare(0, char_traits<char>::length(koutputOption),
+                         koutputOption) == 0) {
+      outFormat = distWriter::parseFormat(
+        arg.substr(char_traits<char>::length(koutputOption)));
+    }
+    else if (arg.compare(0, char_traits<char>::length(korderOption),
+                         korderOption) == 0) {
+      orderKind = Alg::nodeOrder::parseKind(
+        arg.substr(char_traits<char>::length(korderOption)));
+    }
+    else {
+      throw std::invalid_argument{string("Unknown option '") + arg + "'"};
+    }
+  }
+  return numArgs;
+}
+
 // Checks if the number of arguments is correct.
 // Check if the file given at argv[0] exists.
 // Check if the mode string given has proper size.
@@ -103,21 +217,34 @@ bool init::validateArguments(int argc, char** argv) const noexcept
   }
 
   std::stringstream ss;
-  float inDelta = 0.0;
-  ss << argv[3];
-  ss >> inDelta;
-  if (!INRANGE(inDelta, kminDelta, kmaxDelta)) {
-    return false;
+  if (Alg::deltaSelector::parseMode(argv[3]) ==
+      Alg::deltaSelector::mode::fixed) {
+    float inDelta = 0.0;
+    ss << argv[3];
+    ss >> inDelta;
+    if (!INRANGE(inDelta, kminDelta, kmaxDelta)) {
+      return false;
+    }
+    ss.clear();
   }
-  ss.clear();
   
-  if (argc == knumProgArgsWithThreads) {
-    int numThreadsIn = 0;
+  int numThreadsIn = 1;
+  if (argc >= knumProgArgsWithThreads) {
     ss << argv[knumProgArgsWithThreads - 1];
     ss >> numThreadsIn;
     if (!INRANGE(numThreadsIn, kminNumThreads, kmaxNumThreads)) {
       return false;
     }
+    ss.clear();
+  }
+
+  if (argc == knumProgArgsWithGroups) {
+    int numGroupsIn = 0;
+    ss << argv[knumProgArgsWithGroups - 1];
+    ss >> numGroupsIn;
+    if (!INRANGE(numGroupsIn, 1, numThreadsIn)) {
+      return false;
+    }
   }
   
   return true;
@@ -130,23 +257,36 @@ bool init::validateArguments(int argc, char** argv) const noexcept
 void init::processEntries(int argc, char** argv) noexcept(false)
 {
   std::stringstream ss;
-  ss << argv[3];
-  ss >> delta;
-  ss.clear();
-  if (argc == knumProgArgsWithThreads) {
+  deltaMode = Alg::deltaSelector::parseMode(argv[3]);
+  if (deltaMode == Alg::deltaSelector::mode::fixed) {
+    ss << argv[3];
+    ss >> delta;
+    ss.clear();
+  }
+  if (argc >= knumProgArgsWithThreads) {
     ss << argv[knumProgArgsWithThreads - 1];
     ss >> numThreads;
+    ss.clear();
+  }
+  if (argc >= knumProgArgsWithQueries) {
+    queries = queryBatch::readQueries(argv[knumProgArgsWithQueries - 1]);
+  }
+  if (argc == knumProgArgsWithGroups) {
+    ss << argv[knumProgArgsWithGroups - 1];
+    ss >> numGroups;
   }
-  // Read file name, mode, and then open the file and start reading
+  // Read file name, mode, and then map the file and start reading
   // it.
-  openInFile(argv[1], argv[2]);
-
-  ignoreComments();
+  assignInFile(argv[1], argv[2]);
 
   // At this point, the graph has been created, so we must be sure
   // to delete it if an exception occurs.
   try {
     readEdges();
+    reorder();
+    if (isPacking) {
+      inGraph->pack(numThreads);
+    }
   }
   catch(std::exception& e) {
     destroy();
@@ -154,129 +294,39 @@ void init::processEntries(int argc, char** argv) noexcept(false)
   }
 }
 
-void init::openInFile(char const* fileArgName, const char* inModeArg)
+void init::assignInFile(char const* fileArgName, const char* inModeArg)
 {
   inFileName.assign(fileArgName);
   outFileName = str::getOutName(inFileName);
   inMode.assign(inModeArg);
-  inFile.open(inFileName);
 }
   
+// Snapshots written by the convert tool are mapped as they are.
+// Anything else is parsed as a text edge list.
 void init::readEdges() noexcept(false)
 {
-  DEBUG(INTERFACE_INIT_DEBUG, "Start -- readEdges");
-  // Edges in format <source node> <destination node> <weight>
-  //
-  // We use a vector because we assume that the input file will only include
-  // edges for nodes in the graph, so that we are not wasting memory.
-  //
-  // Note that graphNodes and graphEdges should have the same size.
-  const unsigned bitsetAllocSz = 0xFFFF;
-  boost::dynamic_bitset<> graphNodes(bitsetAllocSz);
-  vector<nodeIdT> numEdges(bitsetAllocSz, 0);
-  vector<DS::wEdge<int, int, int> > graphEdges;
-
-  // TODO: use these values! (currently ignoring)
-  // Read header
-  int m = -1;
-  int n = -1;
-  int numNonZeroNodes = -1;
-
-  if (inFileHasHeader) {
-    inFile >> m >> n >> numNonZeroNodes;
-    if (m == -1) throw logic_error{"(readEdges) header -- unexpected EOF"};
-  }
-
-
-  unsigned numNodes = 0;
-  unsigned lineCounter = 1;
-  int maxNodeId = numeric_limits<int>::min();
-  while (inFile.good()) {
-    if (!lineCounter % 1000)
-      LOGATT(INTERFACE_INIT_DEBUG, lineCounter);
-
-    // <node1, node2, weight>
-    DS::wEdge<int, int, int> edge(-1, -1, -1);
-  
-    inFile >> edge.node1() >> edge.node2() >> edge.weight();
-    if (edge.node1() == -1) 
-      break; // Hopefully true means EOF
-
-    // Check if inputs are in the right range
-    num<int>::checkInRange(edge.node1(), 1, kmaxNodeId - 1);
-    num<int>::checkInRange(edge.node2(), 1, kmaxNodeId - 1);
-    num<int>::checkInRange(edge.weight(), 0, kmaxWeight - 1);
-
-    if (edge.node1() > maxNodeId) {
-      maxNodeId = edge.node1();
-    }
-    if (edge.node2() > maxNodeId) {
-      maxNodeId = edge.node2();
-    }
-    // If needed, resize
-#   pragma GCC diagnostic ignored "-Wsign-compare"
-    if (maxNodeId > graphNodes.size()) {
-      graphNodes.resize(num<int>::max(maxNodeId,
-                                      graphNodes.size() + bitsetAllocSz));
-      numEdges.resize(num<int>::max(maxNodeId,
-                                    numEdges.size() + bitsetAllocSz), 0);
-    }
-
-    // Update graphNodes, graphEdges, numEdges
-    graphNodes[edge.node1()] = true;
-    graphNodes[edge.node2()] = true;
-
-    // Fix node ids. Files should come with range starting from 1, but we want
-    // it starting from 0. This makes everything easier, later on.
-    edge.node1()--;
-    edge.node2()--;
-    graphEdges.push_back(edge);
-
-    // LOG(INTERFACE_INIT_DEBUG,
-    //     "About to insert edge %d %d", edge.node1, edge.node2);
-    numEdges.at(edge.node1())++;
-
-    lineCounter++;
+  if (graphSnapshot::isSnapshot(inFileName)) {
+    inGraph = graphSnapshot::load(inFileName,
+                                  INTERFACE_INIT_VERIFY_SNAPSHOT);
+    return;
   }
-
-  if (!inFile.eof()) {
-    throw logic_error{"(readEdges) encountered error while read input file"};
-  }
-  
-  // Allocate all the digraph nodes here. This avoids memory fragmentation.
-  inGraph = new digraph(static_cast<unsigned>(maxNodeId), numEdges);
-  for (auto edge : graphEdges) {
-    inGraph->insertEdge(edge.node1(), edge.node2(), edge.weight(),
-                        --numEdges.at(edge.node1()));
-  }
-
-  DEBUG(INTERFACE_INIT_DEBUG, "End -- readEdges");
+  edgeListReader reader(inFileName, numThreads);
+  inGraph = reader.read();
 }
 
-// Additionally marks if the file has a %%Header (header must to be
-// after '%%').
-void init::ignoreComments() noexcept(false)
+// Like loading the graph, this is not part of the timed run. The bfs
+// order starts from the first source that is going to be run.
+void init::reorder() noexcept(false)
 {
-  DEBUG(INTERFACE_INIT_DEBUG, "Start -- IgnoreComments");
-
-  const unsigned maxLineSz = 0xFFFF;
-  while(inFile.good() && inFile.peek() == '%') {
-    inFile.get();
-    if (inFile.peek() == '%') inFileHasHeader = true;
-    // Ignore line
-    while (inFile.good() && inFile.get() != '\n');
-  }
-
-  LOGATT(INTERFACE_INIT_DEBUG, inFileHasHeader);
-
-  if (inFile.eof()) {
-    throw logic_error{"(ignoreComments) file has no contents."};
+  if (orderKind == Alg::nodeOrder::kind::none) {
+    return;
   }
-  else if (!inFile.good()) {
-    throw logic_error{"(ignoreComments) error reading file."};
-  }
-
-  DEBUG(INTERFACE_INIT_DEBUG, "End -- IgnoreComments");
+  const nodeIdT sourceNode = queries.empty() ? 0 : queries.front().source;
+  order.reset(new Alg::nodeOrder(*inGraph, orderKind, sourceNode));
+  graphT* reordered =
+    inGraph->permute(order->getNewIds(), numThreads).release();
+  delete inGraph;
+  inGraph = reordered;
 }
 
 // For every node in the graph, print its number of outgoing
@@ -284,31 +334,40 @@ void init::ignoreComments() noexcept(false)
 void init::printInGraph() noexcept(false)
 {
   register unsigned i = 0;
-  register unsigned j = 0;
 
   std::cout << "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n";
   std::cout << "Printing input graph\n";
   std::cout << '\n';
   for (i = 0; i < inGraph->size(); ++i) {
-    if (!inGraph->at(i)->isLeaf()) {
+    if (inGraph->outDegree(i) != 0) {
       std::cout << '\n';
-      std::cout << "Node " << inGraph->at(i)->getId() << ":\n";
+      std::cout << "Node " << i << ":\n";
 
-      for (j = 0; j < inGraph->at(i)->size(); ++j) {
-        std::cout << i << ',' << inGraph->at(i)->getEdgeDest(j) << ',' << 
-                  inGraph->at(i)->getEdgeWeight(j) << '\n';
+      for (edgeIdT e = inGraph->outBegin(i); e < inGraph->outEnd(i); ++e) {
+        std::cout << i << ',' << inGraph->target(e) << ',' << 
+                  inGraph->weight(e) << '\n';
       }
     }
   }
   std::cout << "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n";  
 }
 
-void init::writeOut(Alg::deltaStepping& dsRun)
+// With no output, the output file is not even opened, so that a
+// previous one is left as it is.
+template <typename dsRunT>
+void init::writeOut(dsRunT& dsRun)
 {
-  dsRun.printOutToFile(outFileName.c_str());
+  if (outFormat == distWriter::format::none) {
+    return;
+  }
+  distWriter writer(outFormat, numThreads);
+  std::ofstream ofs(outFileName, ios_base::out | ios_base::trunc |
+                      ios_base::binary);
+  writer.write(dsRun, ofs);
 }
 
-void init::printOut(Alg::deltaStepping& dsRun) const
+template <typename dsRunT>
+void init::printOut(dsRunT& dsRun) const
 {
 #if INTERFACE_INIT_PRINT_DISTS
   printOutDists(dsRun);
@@ -325,7 +384,8 @@ void init::printGraphSize() const
   std::cout << " edges\n";
 }
 
-void init::printOutDists(Alg::deltaStepping& dsRun) const
+template <typename dsRunT>
+void init::printOutDists(dsRunT& dsRun) const
 {
   dsRun.printOutToStream(std::cout);
 }
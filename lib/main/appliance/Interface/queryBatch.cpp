@@ -0,0 +1,194 @@
+//===----------------------------------------------------------===//
+// Interface module
+//
+// File purpose: queryBatch class implementation. See class header
+// for more detail.
+//===----------------------------------------------------------===//
+
+#include "Interface/queryBatch.hpp"
+#include "Utils/error.hpp"
+#include "Utils/file.hpp"
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+using namespace Utils;
+
+namespace Interface {
+
+using graphT = DS::csrGraph;
+
+queryBatch::queryBatch(graphT* graph, const std::string& mode,
+                       const float delta, const unsigned numThreads,
+                       const unsigned numGroups,
+                       const bool isTrackingPaths,
+                       const distWriter::format outFormat) noexcept(false)
+  : graph(graph), mode(mode), delta(delta), numGroups(numGroups),
+    threadsPerGroup(numGroups == 0 ? 0 : numThreads / numGroups),
+    isTrackingPaths(isTrackingPaths), order(nullptr),
+    writer(outFormat, threadsPerGroup)
+{
+  if (numGroups == 0 || threadsPerGroup == 0) {
+    throw invalid_argument{string("(queryBatch) cannot split ") +
+                             to_string(numThreads) + " threads in " +
+                             to_string(numGroups) + " groups"};
+  }
+}
+
+void queryBatch::setNodeOrder(const Alg::nodeOrder* order)
+{
+  this->order = order;
+}
+
+vector<queryBatch::query> queryBatch::readQueries(const char* arg)
+  noexcept(false)
+{
+  vector<query> queries;
+  if (file::exists(arg)) {
+    ifstream ifs(arg);
+    parseQueries(ifs, ' ', queries);
+  }
+  else {
+    istringstream iss(arg);
+    parseQueries(iss, ',', queries);
+  }
+  if (queries.empty()) {
+    throw invalid_argument{string("(queryBatch) no queries in '") +
+                             arg + "'"};
+  }
+  return queries;
+}
+
+void queryBatch::parseQueries(std::istream& is, const char sep,
+                              std::vector<query>& queries) noexcept(false)
+{
+  string token;
+  while (sep == ' ' ? static_cast<bool>(is >> token)
+                    : static_cast<bool>(getline(is, token, sep))) {
+    const size_t colonPos = token.find(':');
+    query q;
+    q.source = parseNode(token.substr(0, colonPos));
+    q.target = colonPos == string::npos
+      ? Alg::deltaStepping::knoTarget
+      : parseNode(token.substr(colonPos + 1));
+    queries.push_back(q);
+  }
+}
+
+// Each token is checked on its own, so that a bad one is reported as
+// it is, instead of the stream just stopping there.
+nodeIdT queryBatch::parseNode(const std::string& token) noexcept(false)
+{
+  size_t endPos = 0;
+  unsigned long node = 0;
+  try {
+    node = stoul(token, &endPos);
+  }
+  catch (std::exception&) {
+    endPos = 0;
+  }
+  if (endPos == 0 || endPos != token.size() || token[0] == '-' ||
+      node >= Alg::deltaStepping::knoTarget) {
+    throw invalid_argument{string("(queryBatch) invalid node '") +
+                             token + "'"};
+  }
+  return static_cast<nodeIdT>(node);
+}
+
+// The graph is prepared once here, as the groups would otherwise all
+// do it at the same time.
+void queryBatch::run(const std::vector<query>& queries, std::ostream& os)
+  noexcept(false)
+{
+  LOG(INTERFACE_INIT_DEBUG, "Start -- queryBatch::run");
+  Alg::deltaStepping::prepareGraph(graph, delta, numGroups * threadsPerGroup);
+  if (numGroups > 1) {
+    omp_set_max_active_levels(2);
+  }
+  if (Alg::needsWideDists(*graph)) {
+    runGroups<Alg::wideDeltaStepping>(queries, os);
+  }
+  else {
+    runGroups<Alg::deltaStepping>(queries, os);
+  }
+  LOG(INTERFACE_INIT_DEBUG, "End -- queryBatch::run");
+}
+
+// Exceptions cannot leave a parallel region, so the first one is
+// kept, the other groups stop taking queries, and it is thrown again
+// once they are all done.
+template <typename dsRunT>
+void queryBatch::runGroups(const std::vector<query>& queries,
+                           std::ostream& os) noexcept(false)
+{
+  exception_ptr error = nullptr;
+  bool isFailed = false;
+  #pragma omp parallel num_threads(numGroups)
+  {
+    dsRunT dsRun;
+    dsRun.setIsTrackingPaths(isTrackingPaths);
+    dsRun.setNodeOrder(order);
+    #pragma omp for schedule(dynamic, 1)
+    for (size_t i = 0; i < queries.size(); ++i) {
+      bool isGroupFailed = false;
+      #pragma omp atomic read
+      isGroupFailed = isFailed;
+      if (isGroupFailed) {
+        continue;
+      }
+      try {
+        dsRun.run(graph, mode.c_str(), delta, threadsPerGroup,
+                  queries[i].source, queries[i].target);
+        writeQuery(queries[i], dsRun, os);
+      }
+      catch (std::exception&) {
+        #pragma omp critical (queryBatchError)
+        if (!isFailed) {
+          error = current_exception();
+          #pragma omp atomic write
+          isFailed = true;
+        }
+      }
+    }
+  }
+  if (error) {
+    rethrow_exception(error);
+  }
+}
+
+// As in ~runGroups~, an exception may not leave the critical section, so it
+// is thrown again right after it.
+template <typename dsRunT>
+void queryBatch::writeQuery(const query& q, dsRunT& dsRun, std::ostream& os)
+  noexcept(false)
+{
+  exception_ptr error = nullptr;
+  #pragma omp critical (queryBatchOut)
+  {
+    try {
+      if (writer.getFormat() == distWriter::format::text) {
+        os << "% source " << q.source;
+        if (q.target != Alg::deltaStepping::knoTarget) {
+          os << " target " << q.target;
+        }
+        os << '\n';
+      }
+      writer.write(dsRun, os);
+    }
+    catch (std::exception&) {
+      error = current_exception();
+    }
+  }
+  if (error) {
+    rethrow_exception(error);
+  }
+}
+
+}
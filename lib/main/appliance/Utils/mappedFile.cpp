@@ -0,0 +1,71 @@
+//===----------------------------------------------------------===//
+// Utils module
+//
+// File purpose: implementation of class ~mappedFile~. See header
+// file for more detail.
+//===----------------------------------------------------------===//
+
+#include "Utils/mappedFile.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace Utils {
+
+mappedFile::mappedFile(const std::string& fileName) noexcept(false)
+  : begin(nullptr), sz(0)
+{
+  const int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw logic_error{string("(mappedFile) cannot open '") + fileName +
+                        "': " + strerror(errno)};
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    const int err = errno;
+    close(fd);
+    throw logic_error{string("(mappedFile) cannot stat '") + fileName +
+                        "': " + strerror(err)};
+  }
+  sz = static_cast<size_t>(st.st_size);
+
+  // mmap refuses empty mappings. An empty file is simply an empty
+  // range.
+  if (sz != 0) {
+    void* addr = mmap(nullptr, sz, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      const int err = errno;
+      close(fd);
+      throw logic_error{string("(mappedFile) cannot map '") + fileName +
+                          "': " + strerror(err)};
+    }
+    begin = static_cast<const char*>(addr);
+  }
+  // The mapping keeps its own reference to the file.
+  close(fd);
+}
+
+mappedFile::~mappedFile()
+{
+  if (begin != nullptr) {
+    munmap(const_cast<char*>(begin), sz);
+  }
+}
+
+void mappedFile::adviseSequential() const noexcept
+{
+  if (begin != nullptr) {
+    madvise(const_cast<char*>(begin), sz, MADV_SEQUENTIAL);
+  }
+}
+
+}
@@ -0,0 +1,50 @@
+//===----------------------------------------------------------===//
+// Utils module
+//
+// File purpose: implementation of class ~numa~. See header file for
+// more detail.
+//===----------------------------------------------------------===//
+
+#include "Utils/numa.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace Utils {
+
+// The list is made of ranges "first-last" and single nodes, separated
+// by commas, e.g. "0-1" or "0,2-3".
+unsigned numa::numNodes()
+{
+  ifstream ifs("/sys/devices/system/node/online");
+  string list;
+  if (!getline(ifs, list)) {
+    return 1;
+  }
+  istringstream iss(list);
+  string item;
+  unsigned count = 0;
+  while (getline(iss, item, ',')) {
+    const size_t dash = item.find('-');
+    try {
+      if (dash == string::npos) {
+        stoul(item);
+        ++count;
+      }
+      else {
+        count += stoul(item.substr(dash + 1)) -
+          stoul(item.substr(0, dash)) + 1;
+      }
+    }
+    catch (const logic_error&) {
+      return 1;
+    }
+  }
+  return count == 0 ? 1 : count;
+}
+
+}
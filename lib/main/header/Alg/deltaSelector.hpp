@@ -0,0 +1,86 @@
+//===----------------------------------------------------------===//
+// Alg module
+//
+// File purpose: ~deltaSelector~ class declaration.
+//
+// Description: picks a delta for ~deltaStepping~ out of the graph
+// alone. The estimate follows Meyer and Sanders: with a delta of
+// about maxWeight / averageDegree on uniform weights, a node has
+// about one light edge, and that balances the number of phases
+// against the number of edges relaxed more than once. For other
+// weight distributions we take the weight quantile that keeps one
+// light edge per node, which is the same thing on uniform weights.
+//
+// The estimate may then be refined by running the first buckets of
+// the sequential algorithm with a few deltas around it, and keeping
+// the one with the least work per settled node.
+//===----------------------------------------------------------===//
+
+#ifndef DELTA_SELECTOR_H
+#define DELTA_SELECTOR_H
+
+#include "Alg/deltaStepping.hpp"
+#include "DS/csrGraph.hpp"
+#include "Utils/defs.hpp"
+
+#include <string>
+
+namespace Alg {
+
+class deltaSelector {
+  using graphT = DS::csrGraph;
+
+public:
+  // How the delta given by the user is to be taken.
+  enum class mode { fixed, statistics, sampled };
+  // Values of the delta argument that select the last two modes.
+  static constexpr const char* kstatisticsArg = "auto";
+  static constexpr const char* ksampledArg = "auto-refine";
+
+  struct choice {
+    float delta;
+    std::string reason;
+  };
+
+  deltaSelector(const graphT& graph, const nodeIdT sourceNode,
+                const unsigned numThreads);
+
+  // Returns ~mode::fixed~ if ~arg~ names no automatic mode.
+  static mode parseMode(const char* arg);
+
+  // ~selectMode~ must not be ~mode::fixed~.
+  choice select(const mode selectMode) noexcept(false);
+
+private:
+  // Wanted number of light edges per node.
+  static constexpr double klightPerNode = 1.0;
+  // Edges looked at to estimate the weight distribution.
+  static constexpr unsigned ksampledEdges = 0x10000;
+  // Nodes each candidate delta is run for while refining. Below the
+  // minimum, the sample says nothing about the graph.
+  static constexpr unsigned ksampledNodes = 0x4000;
+  static constexpr unsigned kminSampledNodes = 0x40;
+  // Candidates are the estimate times 2^i, for i in
+  // [-kcandidateSteps, kcandidateSteps].
+  static constexpr int kcandidateSteps = 2;
+  // Cost of one phase of the parallel algorithm (a couple of barriers
+  // and a merge of the buckets), in edge relaxations.
+  static constexpr double kphaseCost = 256.0;
+
+  const graphT& graph;
+  const nodeIdT sourceNode;
+  const unsigned numThreads;
+
+  choice fromStatistics() const;
+  choice refine(const choice& estimate) const;
+  // Work per settled node of the first buckets of a run with ~delta~.
+  // Also gives the number of nodes that were settled.
+  double sampleCost(const float delta, unsigned& settled) const;
+  edgeIdT lightEnd(const nodeIdT nodeId, const float delta) const;
+  unsigned countNonSinks() const;
+  weightT weightQuantile(const double q) const;
+};
+
+}
+
+#endif
@@ -1,7 +1,7 @@
 //===----------------------------------------------------------===//
 // Alg module
 //
-// File purpose: ~deltaStepping~ class declaration.
+// File purpose: ~basicDeltaStepping~ class declaration.
 //===----------------------------------------------------------===//
 
 #ifndef DELTA_STEPPING_H
@@ -12,49 +12,174 @@
 #endif
 
 #include "DS/circVec.hpp"
-#include "DS/digraph.hpp"
+#include "Alg/frontierScheduler.hpp"
+#include "Alg/nodeOrder.hpp"
+#include "Alg/relaxKernel.hpp"
+#include "Alg/runStats.hpp"
+#include "DS/csrGraph.hpp"
+#include "DS/radixHeap.hpp"
 #include "Utils/defs.hpp"
+#include "Utils/noInitAllocator.hpp"
 
 #include "boost/dynamic_bitset.hpp"
 
 #include <fstream>
 #include <limits>
 #include <list>
+#include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 namespace Alg {
 
-typedef weightT distT; // Distance type
-typedef std::vector<distT> distsT;
-typedef std::vector<nodeIdT> buckT;
+// Global buckets are grown before being written to (see
+// ~mergeToGBucks~), so the new slots are left uninitialized.
+typedef std::vector<nodeIdT, Utils::noInitAllocator<nodeIdT> > buckT;
 typedef DS::circVec<buckT> bucksT;
-typedef std::list<std::pair<unsigned, distT> > reqT;
+typedef std::vector<nodeIdT> predsT; // Predecessors
+// A distance in the high half and a predecessor in the low one, so
+// that both are updated by a single compare-and-swap.
+typedef uint64_t distPredT;
 
 typedef std::vector<nodeIdT> lBuckT; // Local
-typedef std::vector<lBuckT> lBucksT; // Local
 
-class deltaStepping {
-  using digraph = DS::digraph<nodeIdT>;
+// The algorithm, on distances of type ~distT~. Edge weights are 32
+// bits, so 32 bit distances overflow once a path is long enough.
+// Graphs whose paths may get that long are run with 64 bit distances
+// instead, and the others keep the narrower ones, which halve the
+// memory taken by the distances (see ~needsWideDists~). Both are
+// compiled in, and picked once the graph is loaded.
+template <typename distT>
+class basicDeltaStepping {
+  using graphT = DS::csrGraph;
 
 public:
-  deltaStepping();
-  ~deltaStepping();
+  // Written by parts when allocated (see ~fillByParts~), so the
+  // allocation itself leaves them uninitialized.
+  typedef std::vector<distT, Utils::noInitAllocator<distT> > distsT;
 
-  void run(digraph* inGraph, const char* mode, const float delta,
-	   const unsigned numThreads);
-  distsT& getDists();
+  basicDeltaStepping();
+  ~basicDeltaStepping();
+
+  // Means that a run has no target node.
+  static constexpr nodeIdT knoTarget = std::numeric_limits<nodeIdT>::max();
+  // Predecessor of the source node, and of the nodes not reached.
+  static constexpr nodeIdT knoPred = std::numeric_limits<nodeIdT>::max();
+  // Distance the text output gives the nodes not reached. It is the
+  // same for both widths of distT, so that the output does not depend
+  // on the one the graph got.
+  static constexpr uint64_t kunreachedDist =
+    std::numeric_limits<uint64_t>::max();
+  // ~dist~ as the text output writes it
+  static inline uint64_t toOutDist(const distT dist)
+  {
+    return dist == std::numeric_limits<distT>::max() ? kunreachedDist : dist;
+  }
+
+  // Checks the arguments of the next runs, and sizes everything they
+  // need for ~inGraph~. Binding again with the same arguments costs
+  // next to nothing.
+  void bind(graphT* inGraph, const char* mode, const float delta,
+	    const unsigned numThreads) noexcept(false);
+  // Computes the distances from ~sourceNode~, with what was last
+  // bound. Only the nodes the previous run reached are reset, so a
+  // run that reaches few nodes takes time in proportion to them, not
+  // to the size of the graph.
+  //
+  // With a ~targetNode~, the run stops as soon as the distance to it
+  // is known, and only that distance is valid (and printed) after it.
+  void solve(const nodeIdT sourceNode = 0,
+	     const nodeIdT targetNode = knoTarget) noexcept(false);
+  // ~bind~, then ~solve~. An object may be run many times, on the
+  // same graph or not; the buffers of a run are kept for the next one.
+  void run(graphT* inGraph, const char* mode, const float delta,
+	   const unsigned numThreads, const nodeIdT sourceNode = 0,
+	   const nodeIdT targetNode = knoTarget);
+  // Gets ~graph~ ready to be run with ~delta~. ~run~ does it on its
+  // own, but graphs shared by concurrent runs must be prepared
+  // beforehand.
+  static void prepareGraph(graphT* graph, const float delta,
+			   const unsigned numThreads);
+  const distsT& getDists() const;
+  nodeIdT getSourceNode() const;
+  nodeIdT getTargetNode() const;
+  // Makes the next runs take and give the node IDs ~order~ was
+  // computed from, while they run on the reordered graph that is
+  // bound. The order must outlive them. With nullptr, node IDs are
+  // the ones of the bound graph.
+  void setNodeOrder(const nodeOrder* order);
+  // Whether the next runs keep the predecessor of every node in its
+  // shortest path, so that the paths can be rebuilt afterwards.
+  void setIsTrackingPaths(const bool isTrackingPaths);
+  bool getIsTrackingPaths() const;
+  // Only valid if paths were tracked in the last run.
+  const predsT& getPreds() const noexcept(false);
+  // The nodes of a shortest path from the source to ~nodeId~, both
+  // included. Empty if ~nodeId~ was not reached. With a target, only
+  // the path to the target is valid.
+  std::vector<nodeIdT> getPath(const nodeIdT nodeId) const noexcept(false);
+  // Counters of the last run of a delta-stepping mode. All zero
+  // unless ALG_DELTASTEPPING_STATS is set.
+  const runStats& getStats() const;
   void printOutToFile(const char* outFileName);
   void printOutToStream(std::ostream& os);
   
 private:
-  digraph* diGraph;
+  // A bucket never has a larger number than the distances in it.
+  typedef distT buckNumT;
+
+  // Distance ~dist~ to ~nodeId~ offered through the edge from ~pred~
+  struct request {
+    nodeIdT nodeId;
+    distT dist;
+    nodeIdT pred;
+  };
+  typedef std::list<request> reqT;
+
+  // Buckets of one thread, laid out as the global ones (see ~bucks~):
+  // ~window[i]~ holds the nodes of bucket ~minBuckNum + i~, and
+  // ~overflow~ those past the window, the closest of which is in
+  // bucket ~overflowMinBuck~.
+  //
+  // A thread keeps the same buckets for the whole run. Clearing them
+  // keeps their memory, so that after the first phases nodes are pushed
+  // without allocating. Only the first ~windowSz~ buckets of ~window~
+  // are in use; the ones after them are always empty.
+  struct lBucksT {
+    std::vector<lBuckT> window;
+    unsigned windowSz = 0;
+    lBuckT overflow;
+    buckNumT overflowMinBuck = std::numeric_limits<buckNumT>::max();
+    // Where bucket fusion moves a bucket to before going through it
+    lBuckT fusionBuck;
+    // Where ~mergeToGBucks~ keeps the slice reserved for every bucket
+    std::vector<unsigned> slices;
+    // Nodes this thread reached first in the run. Not emptied by
+    // ~clear~.
+    lBuckT touched;
+
+    void clear()
+    {
+      for (unsigned i = 0; i < windowSz; ++i) {
+        window[i].clear();
+      }
+      windowSz = 0;
+      overflow.clear();
+      overflowMinBuck = std::numeric_limits<buckNumT>::max();
+    }
+  };
+
+  graphT* graph;
   std::ofstream outFile;
   unsigned numThreads;
+  std::string mode;
+  // The nodes of the graph split for the team of ~numThreads~ (see
+  // ~graphT::partition~), as the graph itself is when built for a
+  // team of that size.
+  std::vector<nodeIdT> parts;
   
-  void initInternalVars(digraph* inGraph, const char* mode,
-			const float delta, const unsigned numThreads);
-  void assignGraph(digraph* inGraph);
+  void assignGraph(graphT* inGraph);
   void invalidMode(const char* mode);
 
   //===--------------------------------------------------------===//
@@ -62,26 +187,115 @@ private:
   //===--------------------------------------------------------===//
   distsT dists;
   bucksT bucks;
+  bool isTrackingPaths;
+  predsT preds;
+  // What the getters hand out when the nodes are reordered: ~dists~
+  // and ~preds~ at the IDs of ~order~ (see ~mapBack~).
+  const nodeOrder* order;
+  distsT outDists;
+  predsT outPreds;
+  // Takes the place of ~dists~ during a parallel run that tracks
+  // paths (while ~isPacked~ is set). Its entries are all infinite
+  // with no predecessor between runs.
+  std::vector<distPredT, Utils::noInitAllocator<distPredT> > distPreds;
+  bool isPacked;
+  // Distances wider than 32 bits do not fit in a ~distPredT~ along
+  // with a node. Their parallel runs that track paths update a
+  // distance and its predecessor together under one of these spin
+  // locks instead, the one at the node's ID modulo kpathLocks.
+  static constexpr bool kisPackable =
+    sizeof(distT) + sizeof(nodeIdT) <= sizeof(distPredT);
+  static constexpr unsigned kpathLocks = 4096;
+  std::vector<unsigned> pathLocks;
+  // Picks the edges that lower their target's distance several at a
+  // time (see ~relaxKernel~). Null when the CPU has no kernel, or the
+  // graph's edges are packed.
+  typename relaxKernel<distT>::filterT simdFilter;
+  // Nodes whose distance is no longer infinite, in the order they
+  // were reached. Outside of them, ~dists~ and ~preds~ hold their
+  // initial values, so the next run only resets these, unless they
+  // are more than 1 / kfullResetDivisor of the nodes.
+  std::vector<nodeIdT> touched;
+  static constexpr unsigned kfullResetDivisor = 8;
 
-  static float delta;
-  const nodeIdT sourceNode;
+  float delta;
+  nodeIdT sourceNode;
+  nodeIdT targetNode;
   // Our reusable definition of infinity
   const distT infDist = std::numeric_limits<distT>::max();
-  const unsigned maxUns = std::numeric_limits<unsigned>::max();
+  // Bucket number of no bucket
+  const buckNumT noBuck = std::numeric_limits<buckNumT>::max();
+
+  // Number of the bucket being processed, counted from distance 0.
+  // Bucket ~i~ holds distances [i * delta, (i + 1) * delta).
+  //
+  // ~bucks~ is a ring over a window of the buckets: bucket
+  // ~minBuckNum + i~ lives at ~bucks.at(i)~, and moving on to a later
+  // bucket only moves the beginning of the ring. The window has room
+  // for every bucket an edge can reach, up to kmaxWindowBucks of them.
+  // Nodes further away than that go to ~overflow~, and are moved into
+  // the window once it gets to ~overflowMinBuck~, the closest bucket
+  // they were put there for.
+  static constexpr unsigned kmaxWindowBucks = 1024;
+  buckNumT minBuckNum;
+  buckT overflow;
+  buckNumT overflowMinBuck;
 
-  omp_lock_t* locks;
+  // Sizes the global buckets (by slot of the ring) and the overflow
+  // will have once the ongoing merge is over, and how many threads
+  // already reserved their part of it.
+  std::vector<unsigned> gBuckSzs;
+  unsigned gOverflowSz;
+  unsigned numReserved;
+  // Hands out the light phases of the parallel modes
+  frontierScheduler scheduler;
+  // A light phase whose frontier has more than 1 / kdenseDivisor of
+  // the nodes takes it as a bitmap instead, one bit per node. This
+  // drops the copies of a node, and the nodes that have moved to an
+  // earlier bucket since they were put in this one. The bitmap is
+  // all zero between phases.
+  static constexpr unsigned kdenseDivisor = 16;
+  // Words of the bitmap taken at once by a thread
+  static constexpr unsigned kdenseChunkWords = 64;
+  bool isDenseFrontier;
+  const nodeIdT* denseSrc;
+  unsigned denseSrcSz;
+  std::vector<uint64_t> denseFrontier;
   // Parallel bucket fusion needs this
   const unsigned kminBuckThreshold;
 
+  // The graph with its edges turned around, for the backward search
+  // of the bidirectional mode, and the graph it was built from.
+  std::unique_ptr<graphT> reverseGraph;
+  const graphT* reverseOf;
+  distsT reverseDists;
+  predsT reversePreds;
+  std::vector<nodeIdT> reverseTouched;
+
+  // Counters of the run (see ~runStats~). Threads count into
+  // ~threadStats~, which is summed into ~stats~ once they are done.
+  struct paddedStats {
+    runStats stats;
+    char pad[64];
+  };
+  runStats stats;
+  std::vector<paddedStats> threadStats;
+
   // rm is the current set of removed nodes
   boost::dynamic_bitset<> rm;
-  std::list<std::pair<unsigned, distT> > req;
+  reqT req;
 
   //===--------------------------------------------------------===//
   // Procedures used by the algorithm
   //===--------------------------------------------------------===//
   // Ground truth algorithm
   void dijkstra();
+  // The same, with a radix heap in place of the binary heap. Meant to
+  // be the fastest sequential mode, rather than a reference.
+  void radixDijkstra();
+  // Point-to-point only: a search from the source and one from the
+  // target, over the reverse graph, until they meet.
+  void bidirectionalDijkstra();
   // These are all the versions of the algorithm, that can be
   // differentiated according to the ~mode~ argument given to the
   // constructor.
@@ -91,12 +305,39 @@ private:
 
   void preprocessingPrl();
   void preprocessing();
-  void postprocessingPrl();
-  unsigned getMinBuckIdx();
+  buckNumT getMinBuckIdx();
   buckT* getMinBuck();
-  void bucketFusion(lBucksT& lBucks);
-  void updateIdxs(unsigned& prevGBuckSz, buckT** gMinBuck, unsigned& gMinBuckIdx,
-		  unsigned& gMinBuckStartIdx);
+  // Moves the window ~numBucks~ buckets further.
+  void advanceWindow(const buckNumT numBucks);
+  buckNumT buckNumOf(const distT dist) const;
+  void refillFromOverflow();
+  bool isTargetSettled() const;
+  distT getTentativeDist(const nodeIdT nodeId) const;
+  void unpackDistPreds();
+  void mapBack();
+  // Adds the nodes ~lBucks~ reached first to ~touched~.
+  void mergeTouched(const lBucksT& lBucks);
+  void initStats();
+  void sumThreadStats();
+  runStats& getThreadStats();
+  // An OpenMP barrier, timed when counting
+  void barrier();
+  const graphT& getReverseGraph();
+  void bidirectionalStep(const graphT& stepGraph,
+			 DS::radixHeap<distT, nodeIdT>& frontier,
+			 distsT& stepDists, predsT& stepPreds,
+			 std::vector<nodeIdT>& stepTouched,
+			 const distsT& otherDists, distT& bestDist,
+			 nodeIdT& meetNode);
+  void bucketFusion(lBucksT& lBucks, lBuckT& settled);
+  void updateIdxs(unsigned& prevGBuckSz, buckT** gMinBuck,
+		  buckNumT& gMinBuckIdx, unsigned& gMinBuckStartIdx);
+  void prepareLightPhase(const buckT* gMinBuck,
+			 const unsigned gMinBuckStartIdx);
+  void runLightPhase(lBuckT& settled, lBucksT& lBucks);
+  void runDenseLightPhase(lBuckT& settled, lBucksT& lBucks);
+  void relaxHeavyIfSettled(const unsigned prevGBuckSz, const buckT* gMinBuck,
+			   lBuckT& settled, lBucksT& lBucks);
   // FIXME: we are currently getting some graph attributes, such as edge weight,
   // from outside the algorithm. This might not be possible in some
   // settings. The function fetchGraphGlobalAtts below is supposed to take care
@@ -107,21 +348,47 @@ private:
   void initBucksDists();
   void initBucks();
   void initDists();
+  void initSimdFilter();
+  // Puts every entry of ~toReset~ back to infinity and of ~resetPreds~
+  // to knoPred (if paths are tracked), given the nodes that ~touched~
+  // them since the last reset.
+  void resetDists(distsT& toReset, predsT& resetPreds,
+		  std::vector<nodeIdT>& touchedNodes);
+  // Sets every entry of ~array~ to ~value~, with thread p of the team
+  // writing the entries of part p. When the array is not of one entry
+  // per node yet, it is allocated anew first, so that its pages are
+  // first written there, and land on the NUMA node of that thread.
+  template <typename arrayT, typename valueT>
+  void fillByParts(arrayT& array, const valueT value);
+  // Request modes
+  static constexpr unsigned klightMode = 0;
+  static constexpr unsigned kheavyMode = 1;
   reqT findRequests(const buckT& curBuck, const unsigned mode);
-  reqT findRequestsAux(const buckT& curBuck, bool (*f) (weightT w));
+  reqT findRequestsAux(const buckT& curBuck, const bool isHeavy);
   reqT findRequests(const boost::dynamic_bitset<>& curBuck, 
                     const unsigned mode);
   reqT findRequestsAux(const boost::dynamic_bitset<>& curBuck, 
-                       bool (*f) (weightT w));
+                       const bool isHeavy);
+  void findNodeRequests(const nodeIdT srcNodeId, const bool isHeavy,
+			reqT& req);
+  template <typename visitT>
+  edgeIdT forLoweringEdges(const distT srcDist, const edgeIdT begin,
+			   const edgeIdT end, visitT visit) const;
+  void checkRequestMode(const unsigned mode);
   void relaxRequests(reqT&);
-  // Relaxes the outgoing edges of srcNodeId
-  void relaxEdgesPrl(nodeIdT srcNodeId, lBucksT& lBucks);
-  void copyToGBuck(bucksT&, lBucksT&);
-  void relax(nodeIdT, distT);
-  static bool isLight(weightT w);
-  static bool isHeavy(weightT w);
+  // Relax the light or heavy outgoing edges of srcNodeId
+  void relaxLightPrl(nodeIdT srcNodeId, lBucksT& lBucks);
+  void relaxHeavyPrl(nodeIdT srcNodeId, lBucksT& lBucks);
+  void relaxEdgesPrl(nodeIdT srcNodeId, const edgeIdT begin,
+		     const edgeIdT end, lBucksT& lBucks);
+  void relaxEdgesPrlPaths(nodeIdT srcNodeId, const edgeIdT begin,
+			  const edgeIdT end, lBucksT& lBucks);
+  void relaxEdgesPrlLocked(nodeIdT srcNodeId, const edgeIdT begin,
+			   const edgeIdT end, lBucksT& lBucks);
+  void pushLocal(const nodeIdT nodeId, const distT dist, lBucksT& lBucks);
+  void mergeToGBucks(lBucksT& lBucks);
+  bool relax(nodeIdT, distT, nodeIdT pred);
   void bitsetListUnion(boost::dynamic_bitset<>&, const buckT&);
-  void recycleBucks();
   
   //===--------------------------------------------------------===//
   // Debugging procedures
@@ -130,11 +397,22 @@ private:
   void printReq(reqT& req);
   void printBs(boost::dynamic_bitset<>& bs);
   void printDists(distsT& dists);
-  void assertEqualRes(void (deltaStepping::* f1)(),
-		      void (deltaStepping::* f2)());
+  void assertEqualRes(void (basicDeltaStepping::* f1)(),
+		      void (basicDeltaStepping::* f2)());
   bool compareDists(distsT&, distsT&);
 };
 
+typedef basicDeltaStepping<uint32_t> deltaStepping;
+typedef basicDeltaStepping<uint64_t> wideDeltaStepping;
+
+// Whether the distances of ~graph~ may be too long for the distances
+// of ~deltaStepping~, so that it has to be run by a
+// ~wideDeltaStepping~. Tentative distances are paths, which have
+// fewer edges than the graph has nodes, and relaxing adds one edge
+// more; none of them is heavier than the heaviest edge. That sum has
+// to stay below the infinite distance.
+bool needsWideDists(const DS::csrGraph& graph);
+
 }
 
 #endif
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------===//
+// Alg module
+//
+// File purpose: ~frontierScheduler~ class declaration.
+//
+// Description: splits the frontier of a light phase into chunks of
+// about the same amount of work, and hands them out to the threads
+// of a team, which steal from each other once their own run out.
+//
+// Work is counted in units: one for each node, plus one for each of
+// its light edges. Node i of the frontier takes the units
+// [prefix[i], prefix[i + 1]); the first one stands for the node
+// itself, and the others for its edges. A chunk is a fixed range of
+// units, so the edges of a high degree node may be spread over many
+// chunks, and over many threads. The thread whose chunk holds the
+// first unit of a node is said to own it.
+//
+// Every thread starts with a contiguous range of chunks. It takes
+// chunks from the front of its range, and, once it is empty, steals
+// the back half of the range of some other thread. A range is a
+// single 64 bit word (first and past-the-last chunk), so both taking
+// and stealing are one compare-and-swap.
+//
+// On machines with several NUMA nodes, the graph and the distances
+// are split in parts, one per thread, each in the memory of the
+// socket its thread runs on (see ~DS::csrGraph::partition~). There,
+// the frontier is first sorted by the part its nodes are in, and
+// every thread starts with the chunks of its own part, so that it
+// reads the edges of the nodes it relaxes from its own socket. Only
+// stolen chunks are read from further away; victims are tried from
+// the next thread on, which, with threads bound close together, is
+// on the same socket first.
+//===----------------------------------------------------------===//
+
+#ifndef FRONTIER_SCHEDULER_H
+#define FRONTIER_SCHEDULER_H
+
+#include "DS/csrGraph.hpp"
+#include "Utils/atomicOps.hpp"
+#include "Utils/defs.hpp"
+#include "Utils/numa.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace Alg {
+
+class frontierScheduler {
+  using graphT = DS::csrGraph;
+
+public:
+  frontierScheduler();
+
+  // Splits the ~frontierSz~ nodes at ~frontier~, for a team of
+  // ~numThreads~ threads among which the nodes are split in ~parts~
+  // (see ~DS::csrGraph::partition~). Must be called by a single
+  // thread, and the frontier must not change until the following
+  // ~run~ is over in every thread.
+  void prepare(const graphT& graph, const nodeIdT* frontier,
+               const unsigned frontierSz, const unsigned numThreads,
+               const std::vector<nodeIdT>& parts);
+
+  // Called by every thread of the team, with its own ~threadId~.
+  // Returns once there are no chunks left anywhere. For each part of
+  // a node that it gets, calls
+  //   visit(nodeId, edgeBegin, edgeEnd, isOwner)
+  // where [edgeBegin, edgeEnd) are light edges of nodeId.
+  template <typename visitorT>
+  void run(const unsigned threadId, visitorT visit)
+  {
+    unsigned chunkIdx = 0;
+    while (true) {
+      if (takeOwn(threadId, chunkIdx)) {
+        visitChunk(chunkIdx, visit);
+      }
+      else if (!steal(threadId)) {
+        break;
+      }
+    }
+  }
+
+private:
+  // Units per chunk
+  static constexpr edgeIdT kchunkUnits = 512;
+
+  // Padded so that every range is in a cache line of its own.
+  struct range {
+    uint64_t word;
+    char pad[64 - sizeof(uint64_t)];
+  };
+
+  const graphT* graph;
+  const nodeIdT* frontier;
+  unsigned frontierSz;
+  // Whether threads start with the chunks of their own part. Only
+  // when the machine has more than one NUMA node.
+  const bool isByPart;
+  // The frontier sorted by part, and where the nodes of every part
+  // begin in it, when ~isByPart~.
+  std::vector<nodeIdT> byPart;
+  std::vector<unsigned> partBegin;
+  std::vector<unsigned> partOf;
+  std::vector<edgeIdT> prefix;
+  edgeIdT numUnits;
+  std::vector<range> ranges;
+
+  static inline uint64_t pack(const unsigned first, const unsigned last)
+  {
+    return (static_cast<uint64_t>(first) << 32) | last;
+  }
+
+  static inline unsigned first(const uint64_t word)
+  {
+    return static_cast<unsigned>(word >> 32);
+  }
+
+  static inline unsigned last(const uint64_t word)
+  {
+    return static_cast<unsigned>(word);
+  }
+
+  void sortByPart(const std::vector<nodeIdT>& parts);
+  bool takeOwn(const unsigned threadId, unsigned& chunkIdx);
+  bool steal(const unsigned threadId);
+
+  template <typename visitorT>
+  void visitChunk(const unsigned chunkIdx, visitorT& visit) const
+  {
+    const edgeIdT lo = chunkIdx * kchunkUnits;
+    const edgeIdT hi = std::min(lo + kchunkUnits, numUnits);
+    // First node whose units go past lo
+    unsigned i = static_cast<unsigned>(
+      std::upper_bound(prefix.begin() + 1, prefix.end(), lo) -
+      (prefix.begin() + 1));
+    for (; i < frontierSz && prefix[i] < hi; ++i) {
+      const nodeIdT nodeId = frontier[i];
+      const edgeIdT p = prefix[i];
+      const edgeIdT outBegin = graph->outBegin(nodeId);
+      const edgeIdT edgeBegin = std::max(lo, p + 1) - p - 1;
+      const edgeIdT edgeEnd = std::min(hi, prefix[i + 1]) - p - 1;
+      visit(nodeId, outBegin + edgeBegin, outBegin + edgeEnd, p >= lo);
+    }
+  }
+};
+
+}
+
+#endif
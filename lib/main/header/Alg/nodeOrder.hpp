@@ -0,0 +1,76 @@
+//===----------------------------------------------------------===//
+// Alg module
+//
+// File purpose: ~nodeOrder~ class declaration.
+//
+// Description: a renumbering of the nodes of a graph, so that the
+// nodes relaxed one after the other have close IDs, and their
+// distances and edges are close in memory. The graph is rebuilt with
+// the new IDs (see ~DS::csrGraph::permute~), and ~deltaStepping~
+// translates node IDs back and forth at its boundary (see
+// ~deltaStepping::setNodeOrder~).
+//
+// rcm:    reverse Cuthill-McKee. A breadth-first search from a node
+//         of least degree, taking the neighbours of every node by
+//         increasing degree, and then the whole order reversed.
+// degree: by decreasing out-degree, so that the hubs, which are
+//         relaxed the most, share cache lines.
+// bfs:    the order a breadth-first search from the source reaches
+//         the nodes in, which is close to the order they are settled
+//         in.
+//
+// Nodes not reached by a search are taken from the next starting
+// node that was not reached either.
+//===----------------------------------------------------------===//
+
+#ifndef NODE_ORDER_H
+#define NODE_ORDER_H
+
+#include "DS/csrGraph.hpp"
+#include "Utils/defs.hpp"
+
+#include <string>
+#include <vector>
+
+namespace Alg {
+
+class nodeOrder {
+  using graphT = DS::csrGraph;
+
+public:
+  enum class kind { none, rcm, degree, bfs };
+  static constexpr const char* knoneArg = "none";
+  static constexpr const char* krcmArg = "rcm";
+  static constexpr const char* kdegreeArg = "degree";
+  static constexpr const char* kbfsArg = "bfs";
+
+  // ~sourceNode~ is only used by the bfs order. With ~kind::none~,
+  // every node keeps its ID.
+  nodeOrder(const graphT& graph, const kind orderKind,
+            const nodeIdT sourceNode) noexcept(false);
+
+  static kind parseKind(const std::string& arg) noexcept(false);
+
+  unsigned size() const;
+  // ID of node ~oldId~ in the reordered graph, and the other way
+  // around.
+  nodeIdT toNew(const nodeIdT oldId) const;
+  nodeIdT toOld(const nodeIdT newId) const;
+  const std::vector<nodeIdT>& getNewIds() const;
+
+private:
+  std::vector<nodeIdT> newIds;
+  std::vector<nodeIdT> oldIds;
+
+  // Breadth-first searches from each node of ~starts~ not reached yet,
+  // appending the nodes to ~oldIds~ as they are reached.
+  void traverse(const graphT& graph, const std::vector<nodeIdT>& starts,
+                const bool isByDegree);
+  void byRcm(const graphT& graph);
+  void byDegree(const graphT& graph);
+  void byBfs(const graphT& graph, const nodeIdT sourceNode) noexcept(false);
+};
+
+}
+
+#endif
@@ -0,0 +1,64 @@
+//===----------------------------------------------------------===//
+// Alg module
+//
+// File purpose: ~relaxKernel~ class declaration.
+//
+// Description: picks, out of the edges of a node, the ones whose
+// distance through the node is below the distance of their target,
+// several edges at a time. The distances through the node are added
+// up for 8 edges at once with AVX2 (4 on 64 bit distances), or 16 at
+// once with AVX-512 (8 on 64 bit distances); the distances of the
+// targets are gathered, compared to them, and only the edges that
+// would lower them are written out, packed together. Most edges do
+// not lower anything, so the scalar loop that relaxes the edges
+// written out is much shorter than the edges of the node.
+//
+// The build targets no instruction set in particular, so the kernels
+// are compiled for theirs on their own, and ~select~ picks the widest
+// one the CPU has when the program runs. On other CPUs, or when
+// ALG_DELTASTEPPING_SIMD is 0, there is none, and the edges are taken
+// one by one as before.
+//
+// The edges are read from the unpacked arrays of a ~DS::csrGraph~.
+// Gathers take signed 32 bit indexes, so targets must be below
+// ~kmaxNodes~.
+//===----------------------------------------------------------===//
+
+#ifndef RELAX_KERNEL_H
+#define RELAX_KERNEL_H
+
+#include "Utils/defs.hpp"
+
+#include <cstdint>
+
+namespace Alg {
+
+template <typename distT>
+class relaxKernel {
+public:
+  // Copies the ~numEdges~ edges of ~targets~ and ~weights~ whose
+  // ~srcDist~ + weight is below the ~dists~ entry of their target to
+  // ~outTargets~ and ~outWeights~, in order, and returns how many
+  // there were. Both outputs must have room for ~kmaxLanes~ more
+  // entries than ~numEdges~, which may be written over.
+  typedef unsigned (*filterT)(const nodeIdT* targets,
+                              const weightT* weights,
+                              const unsigned numEdges,
+                              const distT srcDist, const distT* dists,
+                              nodeIdT* outTargets, weightT* outWeights);
+
+  // Edges are filtered ~kblockSz~ at a time, and only for nodes with
+  // at least ~kminEdges~ edges to relax; the few edges of the others
+  // do not fill enough vectors to be worth it.
+  static constexpr unsigned kblockSz = 64;
+  static constexpr unsigned kminEdges = 16;
+  static constexpr unsigned kmaxLanes = 16;
+  static constexpr unsigned kmaxNodes = INT32_MAX;
+
+  // The widest kernel the CPU has, or null if none.
+  static filterT select();
+};
+
+}
+
+#endif
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------===//
+// Alg module
+//
+// File purpose: ~runStats~ struct declaration and definition.
+//
+// Description: counters of what a run of ~deltaStepping~ did, to
+// tune delta and the number of threads for a graph. They are only
+// kept when ALG_DELTASTEPPING_STATS is set (see Utils/defs.hpp), and
+// are all zero otherwise.
+//
+// Every thread counts into its own copy, away from the cache lines of
+// the others, and the copies are summed at the end of the run. Times
+// are summed over the threads too, so they are in thread-seconds.
+//===----------------------------------------------------------===//
+
+#ifndef RUN_STATS_H
+#define RUN_STATS_H
+
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+
+namespace Alg {
+
+struct runStats {
+  // Buckets that were not empty when taken
+  uint64_t numBuckets = 0;
+  // Light phases, over all buckets, and how many of them had a dense
+  // frontier
+  uint64_t numPhases = 0;
+  uint64_t numDensePhases = 0;
+  // Nodes put back into the bucket being processed
+  uint64_t numReinsertions = 0;
+  // Edges looked at, and how many of them gave a shorter distance
+  uint64_t numRelaxAttempts = 0;
+  uint64_t numRelaxSuccesses = 0;
+  // Local buckets processed by bucket fusion instead of being merged
+  uint64_t numFusionIters = 0;
+  // Waiting at barriers, and merging local buckets into the global
+  // ones (without its barrier)
+  double barrierTime = 0;
+  double mergeTime = 0;
+
+  void add(const runStats& other)
+  {
+    numBuckets += other.numBuckets;
+    numPhases += other.numPhases;
+    numDensePhases += other.numDensePhases;
+    numReinsertions += other.numReinsertions;
+    numRelaxAttempts += other.numRelaxAttempts;
+    numRelaxSuccesses += other.numRelaxSuccesses;
+    numFusionIters += other.numFusionIters;
+    barrierTime += other.barrierTime;
+    mergeTime += other.mergeTime;
+  }
+
+  void print(std::ostream& os) const
+  {
+    os << "Buckets: " << numBuckets << '\n'
+       << "Light phases: " << numPhases << " ("
+       << std::setprecision(2) << std::fixed
+       << (numBuckets == 0 ? 0.0
+                           : static_cast<double>(numPhases) / numBuckets)
+       << " per bucket, " << numDensePhases << " dense)\n"
+       << "Reinsertions: " << numReinsertions << '\n'
+       << "Relaxations: " << numRelaxAttempts << " attempted, "
+       << numRelaxSuccesses << " successful\n"
+       << "Bucket fusion iterations: " << numFusionIters << '\n'
+       << std::setprecision(6)
+       << "Barrier time: " << barrierTime << " s\n"
+       << "Merge time: " << mergeTime << " s\n";
+  }
+};
+
+}
+
+#endif
@@ -9,8 +9,10 @@
 #define DS_H
 
 #include "array.hpp"
-#include "digraph.hpp"
-#include "digraphNode.hpp"
+#include "circVec.hpp"
+#include "csrGraph.hpp"
+#include "packedEdges.hpp"
+#include "radixHeap.hpp"
 #include "wEdge.hpp"
 
 #endif
@@ -23,7 +23,12 @@ public:
   {}
 
   valueT& at(unsigned pos)  {
-    return this->data()[(vecBegin + pos) % this->size()];
+    return this->data()[index(pos)];
+  }
+
+  // Position in the underlying vector of the element ~at(pos)~.
+  unsigned index(unsigned pos) const {
+    return (vecBegin + pos) % this->size();
   }
 
   void setBegin(unsigned newVal)
@@ -0,0 +1,534 @@
+//===----------------------------------------------------------===//
+// DS module
+//
+// File purpose: ~csrGraph~ class declaration and definition.
+//
+// Description: csrGraph is the main type to be used by the
+// delta-stepping algorithm. It stores the graph in compressed sparse
+// row (CSR) form: one offsets array of size numNodes + 1, and the
+// targets and weights of all edges in two contiguous arrays. The
+// outgoing edges of node ~u~ are the positions
+// [offsets[u], offsets[u + 1]) of targets and weights.
+//
+// Compared to an adjacency list of heap-allocated nodes, this
+// removes one allocation per node and the two dependent loads that
+// had to be done before touching the first edge of a node.
+//
+// The three arrays are either owned by the graph (when it is built
+// edge by edge), or borrowed from a memory mapping that the graph
+// keeps alive (when it is loaded from a snapshot file).
+//
+// Once built, the edges of every node are sorted by weight. Then,
+// for any delta, the light edges (weight <= delta) of a node are a
+// prefix of its edges and the heavy ones the rest, and splitting
+// them only takes one binary search per node.
+//
+// Targets and weights may then be packed in fewer bytes (see
+// ~packedEdges~), for graphs that do not fit in memory otherwise.
+// Edges are still taken by ID, only decoding them costs a bit more;
+// loops over the edges of a node go through ~forEdges~, which leaves
+// the unpacked case as it was.
+//
+// On machines with several NUMA nodes, memory goes to the node of
+// the thread that first writes it. So the arrays the graph owns are
+// not written when allocated, but by a team of threads, each one the
+// part of the nodes (see ~partition~) it will relax the most, and the
+// edges of those nodes. With the threads pinned to cores, each part
+// then lives on the socket of its thread.
+//===----------------------------------------------------------===//
+
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include "DS/packedEdges.hpp"
+#include "Utils/defs.hpp"
+#include "Utils/error.hpp"
+#include "Utils/mappedFile.hpp"
+#include "Utils/noInitAllocator.hpp"
+
+#include "omp.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace DS {
+
+class csrGraph {
+public:
+  // Builds the offsets array out of the number of outgoing edges of
+  // every node. After this, the edges must be placed with
+  // ~insertEdge~, each one in a distinct position of its source node.
+  // The arrays are placed for a team of ~numThreads~ threads.
+  explicit csrGraph(const unsigned knumNodes,
+                    const std::vector<unsigned>& numEdges,
+                    const unsigned numThreads)
+    : numNodes(knumNodes), maxEdgeWeight(std::numeric_limits<weightT>::min()),
+      isWeightSorted(false), isSplit(false), lightThreshold(0)
+  {
+    buildOffsets(numEdges, numThreads);
+  }
+
+  // Views arrays that already are in CSR form, with the edges of every
+  // node sorted by weight. Nothing is copied; ~backing~ is the mapping
+  // the arrays live in, and is released together with the graph.
+  explicit csrGraph(const unsigned knumNodes, const edgeIdT knumEdges,
+                    const weightT kmaxEdgeWeight,
+                    const edgeIdT* inOffsets, const nodeIdT* inTargets,
+                    const weightT* inWeights,
+                    std::unique_ptr<Utils::mappedFile> backing)
+    : numNodes(knumNodes), numEdges(knumEdges),
+      maxEdgeWeight(kmaxEdgeWeight), offs(inOffsets), tgts(inTargets),
+      wgts(inWeights), isWeightSorted(true), isSplit(false), lightThreshold(0),
+      backing(std::move(backing))
+  {}
+
+  // Same as above, with the targets and weights packed.
+  explicit csrGraph(const unsigned knumNodes, const edgeIdT knumEdges,
+                    const weightT kmaxEdgeWeight,
+                    const edgeIdT* inOffsets,
+                    std::unique_ptr<packedEdges> inPacked,
+                    std::unique_ptr<Utils::mappedFile> backing)
+    : numNodes(knumNodes), numEdges(knumEdges),
+      maxEdgeWeight(kmaxEdgeWeight), offs(inOffsets), tgts(nullptr),
+      wgts(nullptr), packed(std::move(inPacked)), isWeightSorted(true),
+      isSplit(false), lightThreshold(0), backing(std::move(backing))
+  {}
+
+  csrGraph(const csrGraph&) = delete;
+  csrGraph& operator =(const csrGraph&) = delete;
+
+  // Places the edge ~nodeId1~ -> ~nodeId2~ in the ~pos~-th slot of
+  // the outgoing edges of ~nodeId1~. Distinct slots may be filled
+  // concurrently, which is why the maximum edge weight is not
+  // tracked here: the builder reports it with ~setMaxEdgeWeight~.
+  //
+  // Only valid for graphs that own their arrays.
+  inline void insertEdge(const nodeIdT nodeId1, const nodeIdT nodeId2,
+                         const weightT weight, const unsigned pos)
+  {
+    const edgeIdT edgeId = offs[nodeId1] + pos;
+    targets[edgeId] = nodeId2;
+    weights[edgeId] = weight;
+  }
+
+  inline void setMaxEdgeWeight(const weightT weight)
+  {
+    maxEdgeWeight = weight;
+  }
+
+  // Sorts the edges of every node by weight (then by target, so that
+  // the result does not depend on the order of insertion). Must be
+  // called once all the edges are in place.
+  void sortEdgesByWeight(const unsigned numThreads)
+  {
+    LOG(DS_CSRGRAPH_DEBUG, "Start -- sortEdgesByWeight");
+    #pragma omp parallel num_threads(numThreads)
+    {
+      std::vector<std::pair<weightT, nodeIdT> > edges;
+      #pragma omp for schedule(dynamic, 1024)
+      for (unsigned i = 0; i < numNodes; ++i) {
+        edges.clear();
+        for (edgeIdT e = offsets[i]; e < offsets[i + 1]; ++e) {
+          edges.push_back(std::make_pair(weights[e], targets[e]));
+        }
+        std::sort(edges.begin(), edges.end());
+        edgeIdT e = offsets[i];
+        for (auto& edge : edges) {
+          weights[e] = edge.first;
+          targets[e] = edge.second;
+          ++e;
+        }
+      }
+    }
+    isWeightSorted = true;
+    isSplit = false;
+    LOG(DS_CSRGRAPH_DEBUG, "End -- sortEdgesByWeight");
+  }
+
+  // Packs the targets and weights, and frees the arrays they were in
+  // (a mapping is kept, as the offsets may live in it too). Edges
+  // cannot be inserted or sorted anymore afterwards.
+  void pack(const unsigned numThreads) noexcept(false)
+  {
+    if (!isWeightSorted) {
+      throw std::logic_error{"(csrGraph) pack needs the edges sorted by"\
+                               " weight"};
+    }
+    if (packed) {
+      return;
+    }
+    LOG(DS_CSRGRAPH_DEBUG, "Start -- pack");
+    packed.reset(new packedEdges(tgts, wgts, numEdges, maxEdgeWeight,
+                                 numThreads));
+    targetsT().swap(targets);
+    weightsT().swap(weights);
+    tgts = nullptr;
+    wgts = nullptr;
+    LOG(DS_CSRGRAPH_DEBUG, "End -- pack");
+  }
+
+  // Splits the edges of every node into light (weight <= ~threshold~)
+  // and heavy ones. Does nothing if the threshold did not change
+  // since the last call.
+  void splitLightHeavy(const weightT threshold, const unsigned numThreads)
+    noexcept(false)
+  {
+    if (!isWeightSorted) {
+      throw std::logic_error{"(csrGraph) splitLightHeavy needs the edges"\
+                               " sorted by weight"};
+    }
+    if (isSplit && threshold == lightThreshold) {
+      return;
+    }
+    LOG(DS_CSRGRAPH_DEBUG, "Start -- splitLightHeavy");
+    if (lightDegree.size() != numNodes) {
+      lightDegreeT(numNodes).swap(lightDegree);
+      forParts(partition(numThreads), [&](const unsigned, const nodeIdT first,
+                                          const nodeIdT last) {
+        std::fill(lightDegree.begin() + first, lightDegree.begin() + last, 0);
+      });
+    }
+    #pragma omp parallel for num_threads(numThreads) schedule(dynamic, 1024)
+    for (unsigned i = 0; i < numNodes; ++i) {
+      lightDegree[i] = static_cast<unsigned>(upperBound(i, threshold) - offs[i]);
+    }
+    lightThreshold = threshold;
+    isSplit = true;
+    LOG(DS_CSRGRAPH_DEBUG, "End -- splitLightHeavy");
+  }
+
+  // Makes the next ~splitLightHeavy~ split the edges again, even
+  // with the same threshold. Only needed to time the split.
+  inline void clearSplit()
+  {
+    isSplit = false;
+  }
+
+  // Builds the graph with every edge of this one turned around, with
+  // the same weight. Its edges are sorted by weight too.
+  std::unique_ptr<csrGraph> reverse(const unsigned numThreads) const
+  {
+    LOG(DS_CSRGRAPH_DEBUG, "Start -- reverse");
+    std::vector<unsigned> inDegree(numNodes, 0);
+    for (edgeIdT e = 0; e < numEdges; ++e) {
+      ++inDegree[target(e)];
+    }
+    std::unique_ptr<csrGraph> reversed(new csrGraph(numNodes, inDegree,
+                                                    numThreads));
+    std::vector<unsigned> numPlaced(numNodes, 0);
+    for (unsigned i = 0; i < numNodes; ++i) {
+      for (edgeIdT e = offs[i]; e < offs[i + 1]; ++e) {
+        const nodeIdT nodeId = target(e);
+        reversed->insertEdge(nodeId, i, weight(e), numPlaced[nodeId]++);
+      }
+    }
+    reversed->setMaxEdgeWeight(maxEdgeWeight);
+    reversed->sortEdgesByWeight(numThreads);
+    LOG(DS_CSRGRAPH_DEBUG, "End -- reverse");
+    return reversed;
+  }
+
+  // Builds the graph with node ~i~ renamed to ~newIds[i]~, and the
+  // same edges. Its edges are sorted by weight too.
+  std::unique_ptr<csrGraph> permute(const std::vector<nodeIdT>& newIds,
+                                    const unsigned numThreads) const
+  {
+    LOG(DS_CSRGRAPH_DEBUG, "Start -- permute");
+    std::vector<unsigned> degrees(numNodes);
+    for (unsigned i = 0; i < numNodes; ++i) {
+      degrees[newIds[i]] = outDegree(i);
+    }
+    std::unique_ptr<csrGraph> permuted(new csrGraph(numNodes, degrees,
+                                                    numThreads));
+    #pragma omp parallel for num_threads(numThreads) schedule(dynamic, 1024)
+    for (unsigned i = 0; i < numNodes; ++i) {
+      unsigned pos = 0;
+      for (edgeIdT e = offs[i]; e < offs[i + 1]; ++e) {
+        permuted->insertEdge(newIds[i], newIds[target(e)], weight(e), pos++);
+      }
+    }
+    permuted->setMaxEdgeWeight(maxEdgeWeight);
+    permuted->sortEdgesByWeight(numThreads);
+    LOG(DS_CSRGRAPH_DEBUG, "End -- permute");
+    return permuted;
+  }
+
+  // Splits the nodes into ~numParts~ ranges of consecutive IDs with
+  // about as much work each, counted as in ~Alg::frontierScheduler~:
+  // one unit per node, plus one per edge. Part p is the nodes
+  // [parts[p], parts[p + 1]) of the ~numParts~ + 1 bounds returned.
+  std::vector<nodeIdT> partition(const unsigned numParts) const
+  {
+    const edgeIdT numUnits = numNodes + numEdges;
+    std::vector<nodeIdT> parts(numParts + 1, numNodes);
+    for (unsigned p = 0; p < numParts; ++p) {
+      // First node with at least numUnits * p / numParts units before it
+      const edgeIdT unitsBefore = numUnits * p / numParts;
+      nodeIdT lo = 0;
+      nodeIdT hi = numNodes;
+      while (lo < hi) {
+        const nodeIdT mid = lo + (hi - lo) / 2;
+        if (offs[mid] + mid < unitsBefore) {
+          lo = mid + 1;
+        }
+        else {
+          hi = mid;
+        }
+      }
+      parts[p] = lo;
+    }
+    return parts;
+  }
+
+  // Calls ~visit(p, first, last)~ for every part p of ~parts~, which
+  // holds the nodes [first, last), in thread p of a team of as many
+  // threads as parts. Whatever ~visit~ writes first lands on the NUMA
+  // node of the thread that relaxes part p in a team of that size.
+  template <typename visitT>
+  static void forParts(const std::vector<nodeIdT>& parts, visitT visit)
+  {
+    const unsigned numParts = static_cast<unsigned>(parts.size()) - 1;
+    #pragma omp parallel num_threads(numParts)
+    {
+      // The team may have fewer threads than asked for
+      for (unsigned p = omp_get_thread_num(); p < numParts;
+           p += omp_get_num_threads()) {
+        visit(p, parts[p], parts[p + 1]);
+      }
+    }
+  }
+
+  // Utility functions
+  inline unsigned size() const
+  {
+    return numNodes;
+  }
+
+  inline unsigned getNumNodes() const
+  {
+    return numNodes;
+  }
+
+  inline edgeIdT getNumEdges() const
+  {
+    return numEdges;
+  }
+
+  inline weightT getMaxEdgeWeight() const
+  {
+    return maxEdgeWeight;
+  }
+
+  // Outgoing edges of ~nodeId~ are [outBegin(nodeId), outEnd(nodeId)).
+  inline edgeIdT outBegin(const nodeIdT nodeId) const
+  {
+    return offs[nodeId];
+  }
+
+  inline edgeIdT outEnd(const nodeIdT nodeId) const
+  {
+    return offs[nodeId + 1];
+  }
+
+  inline unsigned outDegree(const nodeIdT nodeId) const
+  {
+    return static_cast<unsigned>(offs[nodeId + 1] - offs[nodeId]);
+  }
+
+  // Light edges of ~nodeId~ are [outBegin(nodeId), lightEnd(nodeId)),
+  // heavy ones [lightEnd(nodeId), outEnd(nodeId)). Only valid after
+  // ~splitLightHeavy~.
+  inline edgeIdT lightEnd(const nodeIdT nodeId) const
+  {
+    return offs[nodeId] + lightDegree[nodeId];
+  }
+
+  // First edge of ~nodeId~ heavier than ~threshold~, or
+  // ~outEnd(nodeId)~ if there is none. Needs the edges sorted by
+  // weight.
+  inline edgeIdT upperBound(const nodeIdT nodeId, const weightT threshold)
+    const
+  {
+    edgeIdT first = offs[nodeId];
+    edgeIdT count = offs[nodeId + 1] - first;
+    while (count > 0) {
+      const edgeIdT step = count / 2;
+      if (weight(first + step) <= threshold) {
+        first += step + 1;
+        count -= step + 1;
+      }
+      else {
+        count = step;
+      }
+    }
+    return first;
+  }
+
+  inline bool getIsWeightSorted() const
+  {
+    return isWeightSorted;
+  }
+
+  inline nodeIdT target(const edgeIdT edgeId) const
+  {
+    return packed ? packed->target(edgeId) : tgts[edgeId];
+  }
+
+  inline weightT weight(const edgeIdT edgeId) const
+  {
+    return packed ? packed->weight(edgeId) : wgts[edgeId];
+  }
+
+  // Calls ~visit(target, weight)~ for the edges [first, last), in
+  // order. Faster than taking them one by one when packed.
+  template <typename visitT>
+  inline void forEdges(const edgeIdT first, const edgeIdT last,
+                       visitT visit) const
+  {
+    if (packed) {
+      packed->forEdges(first, last, visit);
+      return;
+    }
+    for (edgeIdT e = first; e < last; ++e) {
+      visit(tgts[e], wgts[e]);
+    }
+  }
+
+  // Packed targets and weights, or null if they are not packed.
+  inline const packedEdges* getPacked() const
+  {
+    return packed.get();
+  }
+
+  // Raw arrays, of sizes numNodes + 1, numEdges and numEdges. Targets
+  // and weights are null once packed.
+  inline const edgeIdT* getOffsets() const
+  {
+    return offs;
+  }
+
+  inline const nodeIdT* getTargets() const
+  {
+    return tgts;
+  }
+
+  inline const weightT* getWeights() const
+  {
+    return wgts;
+  }
+
+private:
+  unsigned numNodes;
+  edgeIdT numEdges;
+  weightT maxEdgeWeight;
+
+  // What the accessors read. They point either into the vectors
+  // below or into ~backing~.
+  const edgeIdT* offs;
+  const nodeIdT* tgts;
+  const weightT* wgts;
+
+  typedef std::vector<edgeIdT, Utils::noInitAllocator<edgeIdT> > offsetsT;
+  typedef std::vector<nodeIdT, Utils::noInitAllocator<nodeIdT> > targetsT;
+  typedef std::vector<weightT, Utils::noInitAllocator<weightT> > weightsT;
+  typedef std::vector<unsigned, Utils::noInitAllocator<unsigned> >
+    lightDegreeT;
+
+  offsetsT offsets;
+  targetsT targets;
+  weightsT weights;
+
+  std::unique_ptr<packedEdges> packed;
+
+  bool isWeightSorted;
+  bool isSplit;
+  weightT lightThreshold;
+  // Number of light edges of each node
+  lightDegreeT lightDegree;
+
+  std::unique_ptr<Utils::mappedFile> backing;
+
+  // Same split as ~partition~, out of the degrees, before there are
+  // offsets to search.
+  std::vector<nodeIdT> partitionDegrees(const std::vector<unsigned>& degrees,
+                                        const unsigned numParts) const
+  {
+    edgeIdT numUnits = numNodes;
+    for (unsigned i = 0; i < numNodes; ++i) {
+      numUnits += degrees[i];
+    }
+    std::vector<nodeIdT> parts(numParts + 1, numNodes);
+    unsigned p = 0;
+    edgeIdT unitsBefore = 0;
+    for (unsigned i = 0; i < numNodes && p < numParts; ++i) {
+      while (p < numParts && unitsBefore >= numUnits * p / numParts) {
+        parts[p++] = i;
+      }
+      unitsBefore += 1 + degrees[i];
+    }
+    return parts;
+  }
+
+  // An exclusive prefix sum over the degrees, done by parts: each
+  // thread sums the degrees of its part, and, once the sums before it
+  // are known, writes the offsets of its nodes and clears their
+  // edges. Targets and weights are allocated all at once, so that the
+  // edges of nodes with close IDs are also close in memory.
+  void buildOffsets(const std::vector<unsigned>& numEdgesIn,
+                    const unsigned numThreads) noexcept(false)
+  {
+    LOG(DS_CSRGRAPH_DEBUG, "Start -- buildOffsets");
+    if (numEdgesIn.size() < numNodes) {
+      throw std::invalid_argument{
+        std::string("(csrGraph) expected degrees for ") +
+          std::to_string(numNodes) + " nodes, got " +
+          std::to_string(numEdgesIn.size())};
+    }
+    const std::vector<nodeIdT> parts =
+      partitionDegrees(numEdgesIn, numThreads == 0 ? 1 : numThreads);
+    std::vector<edgeIdT> partFirstEdge(parts.size(), 0);
+    forParts(parts, [&](const unsigned p, const nodeIdT first,
+                        const nodeIdT last) {
+      edgeIdT acc = 0;
+      for (unsigned i = first; i < last; ++i) {
+        acc += numEdgesIn[i];
+      }
+      partFirstEdge[p + 1] = acc;
+    });
+    for (unsigned p = 1; p < partFirstEdge.size(); ++p) {
+      partFirstEdge[p] += partFirstEdge[p - 1];
+    }
+    numEdges = partFirstEdge.back();
+    offsets.resize(numNodes + 1);
+    targets.resize(numEdges);
+    weights.resize(numEdges);
+    offsets[numNodes] = numEdges;
+    forParts(parts, [&](const unsigned p, const nodeIdT first,
+                        const nodeIdT last) {
+      edgeIdT acc = partFirstEdge[p];
+      for (unsigned i = first; i < last; ++i) {
+        offsets[i] = acc;
+        acc += numEdgesIn[i];
+      }
+      std::fill(targets.begin() + partFirstEdge[p],
+                targets.begin() + partFirstEdge[p + 1], 0);
+      std::fill(weights.begin() + partFirstEdge[p],
+                weights.begin() + partFirstEdge[p + 1], 0);
+    });
+
+    offs = offsets.data();
+    tgts = targets.data();
+    wgts = weights.data();
+    LOG(DS_CSRGRAPH_DEBUG, "End -- buildOffsets");
+  }
+
+};
+
+}
+
+#endif
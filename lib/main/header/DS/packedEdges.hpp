@@ -0,0 +1,255 @@
+//===----------------------------------------------------------===//
+// DS module
+//
+// File purpose: ~packedEdges~ class declaration and definition.
+//
+// Description: the targets and weights of the edges of a
+// ~csrGraph~, each stored in as few bytes as it needs, instead of 4
+// bytes each.
+//
+// The edges are split in groups of ~kgroupSz~ consecutive edges. A
+// group stores the least of its targets as its base, and every target
+// as its difference from the base, in the least number of bytes that
+// holds the largest difference. The edges of a node are sorted by
+// weight rather than by target, so their targets cannot be stored as
+// gaps from one another; but when nodes whose IDs are close point to
+// nodes whose IDs are close (see ~Alg::nodeOrder~), the differences
+// within a group are small all the same.
+//
+// Weights all take the same number of bytes, the least that holds
+// the maximum edge weight. They are stored right after the targets of
+// their group, so that the edges of a node are in as few cache lines
+// as possible:
+//
+// [group 0 targets][group 0 weights][group 1 targets]...
+//
+// Any edge is decoded on its own, from its group and 4 bytes that the
+// bytes it does not use are masked off of. So edges can still be
+// taken by ID, as the algorithm does. Ranges of edges are decoded a
+// group at a time instead (see ~forEdges~). Values are stored
+// little-endian, and decoded on little-endian machines only.
+//
+// The arrays are either owned (when packed from a graph in memory),
+// or borrowed from a memory mapping (when loaded from a snapshot).
+// Owned ones are first written by the threads that pack them, each
+// its own groups, so they are spread over the NUMA nodes of the
+// machine as the unpacked arrays were (see ~csrGraph~).
+//===----------------------------------------------------------===//
+
+#ifndef PACKED_EDGES_H
+#define PACKED_EDGES_H
+
+#include "Utils/defs.hpp"
+#include "Utils/noInitAllocator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace DS {
+
+class packedEdges {
+  static_assert(sizeof(nodeIdT) == sizeof(uint32_t) &&
+                  sizeof(weightT) == sizeof(uint32_t),
+                "(packedEdges) node IDs and weights must be 4 bytes wide");
+
+public:
+  static constexpr unsigned kgroupSz = 32;
+  // Bytes after the last group, so that reading 4 bytes from any
+  // value stays inside the array.
+  static constexpr unsigned kpadding = sizeof(uint32_t) - 1;
+
+  struct group {
+    // Byte position of the first target of the group
+    uint64_t pos;
+    nodeIdT base;
+    uint32_t width;
+  };
+
+  // Packs ~numEdges~ targets and weights, the largest of which is
+  // ~maxWeight~.
+  explicit packedEdges(const nodeIdT* targets, const weightT* weights,
+                       const edgeIdT knumEdges, const weightT maxWeight,
+                       const unsigned numThreads)
+    : numEdges(knumEdges), weightWidth(widthOf(maxWeight))
+  {
+    pack(targets, weights, numThreads);
+  }
+
+  // Views arrays laid out by another ~packedEdges~ (see the getters
+  // below). Nothing is copied.
+  explicit packedEdges(const edgeIdT knumEdges, const unsigned kweightWidth,
+                       const group* inGroups, const unsigned char* inBytes,
+                       const uint64_t kbytesSz)
+    : numEdges(knumEdges), weightWidth(kweightWidth), grps(inGroups),
+      edgeBytes(inBytes), bytesSz(kbytesSz)
+  {}
+
+  packedEdges(const packedEdges&) = delete;
+  packedEdges& operator =(const packedEdges&) = delete;
+
+  inline nodeIdT target(const edgeIdT edgeId) const
+  {
+    const group& grp = grps[edgeId / kgroupSz];
+    return grp.base + read(edgeBytes + grp.pos +
+                             (edgeId % kgroupSz) * grp.width, grp.width);
+  }
+
+  inline weightT weight(const edgeIdT edgeId) const
+  {
+    const group& grp = grps[edgeId / kgroupSz];
+    return read(weightsOf(grp) + (edgeId % kgroupSz) * weightWidth,
+                weightWidth);
+  }
+
+  // Calls ~visit(target, weight)~ for the edges [first, last), in
+  // order.
+  template <typename visitT>
+  inline void forEdges(edgeIdT first, const edgeIdT last, visitT visit) const
+  {
+    const uint32_t weightMask = maskOf(weightWidth);
+    while (first < last) {
+      const group& grp = grps[first / kgroupSz];
+      const uint32_t mask = maskOf(grp.width);
+      const edgeIdT groupEnd =
+        std::min(last, (first / kgroupSz + 1) * kgroupSz);
+      const unsigned char* t =
+        edgeBytes + grp.pos + (first % kgroupSz) * grp.width;
+      const unsigned char* w =
+        weightsOf(grp) + (first % kgroupSz) * weightWidth;
+      for (; first < groupEnd; ++first) {
+        visit(grp.base + (read(t) & mask), read(w) & weightMask);
+        t += grp.width;
+        w += weightWidth;
+      }
+    }
+  }
+
+  // Number of bytes needed to hold ~value~, at least 1.
+  static inline unsigned widthOf(const uint32_t value)
+  {
+    unsigned width = 1;
+    while (width < sizeof(uint32_t) && (value >> (8 * width)) != 0) {
+      ++width;
+    }
+    return width;
+  }
+
+  static inline edgeIdT numGroupsOf(const edgeIdT numEdges)
+  {
+    return (numEdges + kgroupSz - 1) / kgroupSz;
+  }
+
+  // Raw arrays, of numGroupsOf(numEdges) groups and ~getBytesSz~
+  // bytes, padding included.
+  inline const group* getGroups() const
+  {
+    return grps;
+  }
+
+  inline const unsigned char* getBytes() const
+  {
+    return edgeBytes;
+  }
+
+  inline uint64_t getBytesSz() const
+  {
+    return bytesSz;
+  }
+
+  inline unsigned getWeightWidth() const
+  {
+    return weightWidth;
+  }
+
+private:
+  edgeIdT numEdges;
+  unsigned weightWidth;
+
+  // What the accessors read. They point either into the vectors
+  // below or into a mapping.
+  const group* grps;
+  const unsigned char* edgeBytes;
+  uint64_t bytesSz;
+
+  std::vector<group, Utils::noInitAllocator<group> > groups;
+  std::vector<unsigned char, Utils::noInitAllocator<unsigned char> > bytes;
+
+  // Every group takes room for ~kgroupSz~ edges, the last one too.
+  inline const unsigned char* weightsOf(const group& grp) const
+  {
+    return edgeBytes + grp.pos + kgroupSz * grp.width;
+  }
+
+  static inline uint32_t maskOf(const unsigned width)
+  {
+    return ~uint32_t(0) >> (8 * (sizeof(uint32_t) - width));
+  }
+
+  static inline uint32_t read(const unsigned char* p)
+  {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+  }
+
+  static inline uint32_t read(const unsigned char* p, const unsigned width)
+  {
+    return read(p) & maskOf(width);
+  }
+
+  static inline void write(unsigned char* p, const uint32_t value,
+                           const unsigned width)
+  {
+    for (unsigned i = 0; i < width; ++i) {
+      p[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+  }
+
+  // Widths first, then the positions they give, then the values.
+  void pack(const nodeIdT* targets, const weightT* weights,
+            const unsigned numThreads)
+  {
+    const edgeIdT numGroups = numGroupsOf(numEdges);
+    groups.resize(numGroups);
+    #pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (edgeIdT g = 0; g < numGroups; ++g) {
+      const edgeIdT first = g * kgroupSz;
+      const edgeIdT last = std::min(first + kgroupSz, numEdges);
+      const auto range = std::minmax_element(targets + first, targets + last);
+      groups[g].base = *range.first;
+      groups[g].width = widthOf(*range.second - *range.first);
+    }
+    uint64_t pos = 0;
+    for (edgeIdT g = 0; g < numGroups; ++g) {
+      groups[g].pos = pos;
+      pos += kgroupSz * (groups[g].width + weightWidth);
+    }
+    bytesSz = pos + kpadding;
+    bytes.resize(bytesSz);
+    memset(bytes.data() + pos, 0, kpadding);
+    grps = groups.data();
+    edgeBytes = bytes.data();
+    #pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (edgeIdT g = 0; g < numGroups; ++g) {
+      const group& grp = groups[g];
+      unsigned char* t = bytes.data() + grp.pos;
+      unsigned char* w = t + kgroupSz * grp.width;
+      memset(t, 0, kgroupSz * (grp.width + weightWidth));
+      const edgeIdT first = g * kgroupSz;
+      const edgeIdT last = std::min(first + kgroupSz, numEdges);
+      for (edgeIdT e = first; e < last; ++e) {
+        write(t, targets[e] - grp.base, grp.width);
+        write(w, weights[e], weightWidth);
+        t += grp.width;
+        w += weightWidth;
+      }
+    }
+  }
+
+};
+
+}
+
+#endif
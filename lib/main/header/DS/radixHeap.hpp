@@ -0,0 +1,148 @@
+//===----------------------------------------------------------===//
+// DS module
+//
+// File purpose: ~radixHeap~ class declaration and definition.
+//
+// Description: a monotone priority queue for unsigned integer keys
+// (Ahuja et al., 1990). Keys pushed may never be smaller than the
+// last key popped, which is always the case in Dijkstra's algorithm
+// with non-negative weights.
+//
+// An element goes to bucket i when its key first differs from the
+// last key popped at bit i - 1 (bucket 0 holds the keys equal to
+// it). When bucket 0 runs out, the lowest non-empty bucket is split
+// over the buckets below it, around its own minimum. Every element
+// only ever moves to lower buckets, so it moves at most once per bit
+// of the key.
+//===----------------------------------------------------------===//
+
+#ifndef RADIX_HEAP_H
+#define RADIX_HEAP_H
+
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace DS {
+
+template <typename keyType, typename valueType>
+class radixHeap {
+  static_assert(std::is_unsigned<keyType>::value,
+                "radixHeap keys must be unsigned integers");
+
+public:
+  using elemT = std::pair<keyType, valueType>;
+
+  radixHeap() : last(0), numElems(0)
+  {}
+
+  inline bool empty() const
+  {
+    return numElems == 0;
+  }
+
+  inline size_t size() const
+  {
+    return numElems;
+  }
+
+  void clear()
+  {
+    for (auto& buck : bucks) {
+      buck.clear();
+    }
+    last = 0;
+    numElems = 0;
+  }
+
+  inline void push(const keyType key, const valueType& value)
+    noexcept(false)
+  {
+    if (key < last) {
+      throw std::logic_error{"(radixHeap) key below the last one popped"};
+    }
+    bucks[buckIdx(key)].push_back(std::make_pair(key, value));
+    ++numElems;
+  }
+
+  // One of the elements with the smallest key, which is the next one
+  // ~pop~ returns.
+  const elemT& top() noexcept(false)
+  {
+    if (numElems == 0) {
+      throw std::logic_error{"(radixHeap) top on empty heap"};
+    }
+    if (bucks[0].empty()) {
+      redistribute();
+    }
+    return bucks[0].back();
+  }
+
+  // Removes and returns one of the elements with the smallest key.
+  elemT pop() noexcept(false)
+  {
+    if (numElems == 0) {
+      throw std::logic_error{"(radixHeap) pop on empty heap"};
+    }
+    if (bucks[0].empty()) {
+      redistribute();
+    }
+    elemT top = bucks[0].back();
+    bucks[0].pop_back();
+    --numElems;
+    return top;
+  }
+
+private:
+  static constexpr unsigned knumBucks =
+    std::numeric_limits<keyType>::digits + 1;
+
+  std::vector<elemT> bucks[knumBucks];
+  keyType last;
+  size_t numElems;
+
+  // Number of bits needed to write ~x~
+  static inline unsigned bitWidth(const keyType x)
+  {
+    if (x == 0) {
+      return 0;
+    }
+    if (sizeof(keyType) <= sizeof(unsigned)) {
+      return std::numeric_limits<unsigned>::digits -
+        __builtin_clz(static_cast<unsigned>(x));
+    }
+    return std::numeric_limits<unsigned long long>::digits -
+      __builtin_clzll(static_cast<unsigned long long>(x));
+  }
+
+  inline unsigned buckIdx(const keyType key) const
+  {
+    return bitWidth(key ^ last);
+  }
+
+  void redistribute()
+  {
+    unsigned i = 1;
+    while (bucks[i].empty()) {
+      ++i;
+    }
+    keyType newLast = bucks[i].front().first;
+    for (const auto& elem : bucks[i]) {
+      if (elem.first < newLast) {
+        newLast = elem.first;
+      }
+    }
+    last = newLast;
+    for (const auto& elem : bucks[i]) {
+      bucks[buckIdx(elem.first)].push_back(elem);
+    }
+    bucks[i].clear();
+  }
+};
+
+}
+
+#endif
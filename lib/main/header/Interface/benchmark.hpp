@@ -0,0 +1,132 @@
+//===----------------------------------------------------------===//
+// Interface module
+//
+// File purpose: benchmark class header
+//
+// Description: runs every combination of graph, thread count, mode
+// and delta of a sweep, and reports how long each phase took:
+//
+// load:       reading the graph, once per graph and thread count.
+// preprocess: choosing delta (if it is automatic) and splitting the
+//             edges in light and heavy ones.
+// solve:      the run of the algorithm itself.
+// output:     writing the distances out with ~distWriter~.
+//
+// The last three are timed for every repetition, after some warmup
+// repetitions that are not recorded. For each of them, the report
+// gives the minimum, median, 90th percentile, maximum and mean.
+//
+// The report is either CSV, with the machine described in comment
+// lines at the top, or a single JSON object.
+//
+// Dijkstra modes do not depend on delta, so they are only run with
+// the first delta of the sweep.
+//
+// When ALG_DELTASTEPPING_STATS is set, the counters of the last
+// repetition (see ~Alg::runStats~) are reported too.
+//===----------------------------------------------------------===//
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "Alg/deltaSelector.hpp"
+#include "Alg/deltaStepping.hpp"
+#include "DS/csrGraph.hpp"
+#include "Interface/distWriter.hpp"
+#include "Utils/defs.hpp"
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Interface {
+
+class benchmark {
+  using graphT = DS::csrGraph;
+
+public:
+  enum class format { csv, json };
+  static constexpr const char* kcsvArg = "csv";
+  static constexpr const char* kjsonArg = "json";
+
+  struct sweep {
+    std::vector<std::string> graphs;
+    std::vector<std::string> modes{"dijkstra", "parallel",
+                                   "parallel-bucket-fusion"};
+    // Numbers, or the names of the automatic modes of
+    // ~Alg::deltaSelector~.
+    std::vector<std::string> deltas{"auto"};
+    std::vector<unsigned> threads{1};
+    unsigned numReps = 5;
+    unsigned numWarmups = 1;
+    nodeIdT sourceNode = 0;
+    nodeIdT targetNode = Alg::deltaStepping::knoTarget;
+    distWriter::format outFormat = distWriter::format::text;
+    // Where the distances are written to. Only the last repetition is
+    // left there.
+    std::string outFileName = "/dev/null";
+  };
+
+  explicit benchmark(const sweep& inSweep) noexcept(false);
+
+  static format parseFormat(const std::string& arg) noexcept(false);
+
+  // Runs the whole sweep, and then writes the report to ~os~.
+  // Progress goes to stderr.
+  void run(std::ostream& os, const format reportFormat) noexcept(false);
+
+private:
+  struct stats {
+    double min;
+    double median;
+    double p90;
+    double max;
+    double mean;
+  };
+
+  struct result {
+    std::string graph;
+    unsigned numNodes;
+    edgeIdT numEdges;
+    std::string mode;
+    std::string deltaArg;
+    float delta;
+    unsigned numThreads;
+    double loadTime;
+    stats preprocess;
+    stats solve;
+    stats output;
+    Alg::runStats runStats;
+  };
+
+  const sweep swp;
+  std::vector<result> results;
+
+  static graphT* loadGraph(const std::string& fileName,
+                           const unsigned numThreads) noexcept(false);
+  static bool isDijkstraMode(const std::string& mode);
+  // Repetitions of one combination
+  void runCase(graphT* graph, result& res) noexcept(false);
+  // The same, once ~res.delta~ is parsed, on distances as wide as
+  // the graph needs (see ~Alg::needsWideDists~).
+  template <typename dsRunT>
+  void runReps(graphT* graph, result& res,
+               const Alg::deltaSelector::mode deltaMode) noexcept(false);
+  // Sorts ~samples~.
+  static stats summarize(std::vector<double>& samples);
+
+  void writeCsv(std::ostream& os) const;
+  void writeJson(std::ostream& os) const;
+
+  // Pairs of name and value describing the machine and the build.
+  static std::vector<std::pair<std::string, std::string> > machineInfo();
+  static std::string jsonString(const std::string& s);
+  // ~delta~ with as many digits as it takes to read the same float
+  // back, so that a reported delta reruns the case that was timed.
+  static std::string deltaString(const float delta);
+};
+
+}
+
+#endif
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------===//
+// Interface module
+//
+// File purpose: distWriter class header
+//
+// Description: writes the result of a run of ~Alg::deltaStepping~ in
+// one of these formats:
+//
+// none:   nothing at all, for when only the timing matters.
+// text:   the same lines as ~Alg::deltaStepping::printOutToStream~.
+//         Chunks of nodes are formatted by many threads at once, and
+//         each chunk goes to the stream with a single write, in order.
+// binary: the distances as they are in memory, without the nodes
+//         that were not reached:
+//
+// [header]
+// [reached]  ceil(numNodes / 64) 64-bit words; bit i % 64 of word
+//            i / 64 is set if node i was reached
+// [dists]    numReached distances, in the order of the nodes, of
+//            distSz bytes each (4, or 8 for graphs that need wide
+//            distances, see ~Alg::needsWideDists~)
+// [preds]    numReached node IDs, only if the paths were tracked
+//
+// A run with a target only reaches its target. Batches of runs write
+// one such record per run, one after the other.
+//===----------------------------------------------------------===//
+
+#ifndef DIST_WRITER_H
+#define DIST_WRITER_H
+
+#include "Alg/deltaStepping.hpp"
+#include "Utils/defs.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Interface {
+
+class distWriter {
+public:
+  enum class format { none, text, binary };
+  static constexpr const char* knoneArg = "none";
+  static constexpr const char* ktextArg = "text";
+  static constexpr const char* kbinaryArg = "binary";
+  static constexpr uint32_t kversion = 1;
+
+  distWriter(const format outFormat, const unsigned numThreads);
+
+  static format parseFormat(const std::string& arg) noexcept(false);
+
+  format getFormat() const;
+
+  // ~os~ must have been opened in binary mode for the binary format.
+  // Distances are written as wide as ~distT~.
+  template <typename distT>
+  void write(Alg::basicDeltaStepping<distT>& dsRun, std::ostream& os)
+    noexcept(false);
+
+private:
+  static constexpr char kmagic[8] = {'D', 'S', 'D', 'I', 'S', 'T', 'S', '\0'};
+  static constexpr uint32_t kbyteOrderMark = 0x01020304;
+  // Nodes formatted at once by one thread, in the text format.
+  static constexpr unsigned kchunkNodes = 0x10000;
+  // Longest line of the text format: two 32-bit nodes, a 64-bit
+  // distance, two blanks and the line break.
+  static constexpr unsigned kmaxLineLen = 2 * 10 + 20 + 3;
+
+  struct header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint8_t nodeIdSz;
+    uint8_t distSz;
+    uint8_t hasPreds;
+    uint8_t reserved[5];
+    uint64_t numNodes;
+    uint64_t numReached;
+    uint64_t sourceNode;
+    // All ones for runs without a target
+    uint64_t targetNode;
+  };
+
+  const format outFormat;
+  const unsigned numThreads;
+
+  template <typename distT>
+  void writeText(Alg::basicDeltaStepping<distT>& dsRun, std::ostream& os);
+  template <typename distT>
+  void writeBinary(Alg::basicDeltaStepping<distT>& dsRun, std::ostream& os);
+  static void checkStream(const std::ostream& os) noexcept(false);
+};
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------===//
+// Interface module
+//
+// File purpose: edgeListReader class header
+//
+// Description: this class loads a text edge list (optionally with a
+// MatrixMarket header) into a ~DS::csrGraph~. The file is memory
+// mapped and split into newline-aligned chunks, which are parsed in
+// parallel with a hand-written integer scanner. Edges go straight
+// from the file into their final slot in the graph, without any
+// intermediate list of edges.
+//
+// Accepted format:
+// [COMMENT -> COMMENT COMMENT] where COMMENT ::= %*.*\n
+// [<rows> <columns> <entries>] if some comment starts with '%%'
+// <node1> <node2> <weight>
+// <node1> <node2> <weight>
+// ...
+//===----------------------------------------------------------===//
+
+#ifndef EDGE_LIST_READER_H
+#define EDGE_LIST_READER_H
+
+#include "DS/csrGraph.hpp"
+#include "Utils/defs.hpp"
+#include "Utils/mappedFile.hpp"
+
+#include <string>
+#include <vector>
+
+namespace Interface {
+
+class edgeListReader {
+  using graphT = DS::csrGraph;
+
+public:
+  // Constants for reading graph
+  static constexpr unsigned kmaxNodeId = 0xFFFFFFF;
+  static constexpr unsigned kmaxWeight = 0xFFFFFFF;
+
+  edgeListReader(const std::string& inFileName, const unsigned numThreads)
+    noexcept(false);
+
+  // Builds the graph. Ownership of the returned object goes to the
+  // caller.
+  graphT* read() noexcept(false);
+
+  bool hasHeader() const
+  {
+    return inFileHasHeader;
+  }
+
+private:
+  // Chunks per thread. More than one evens out lines of different
+  // lengths.
+  static constexpr unsigned kchunksPerThread = 4;
+  // Below this, splitting the file costs more than it gains.
+  static constexpr size_t kminChunkSz = 0x10000;
+
+  struct chunk {
+    const char* begin;
+    const char* end;
+  };
+
+  Utils::mappedFile inFile;
+  const unsigned numThreads;
+  bool inFileHasHeader;
+  // Header contents. Zero when there is no header.
+  unsigned hdrRows;
+  unsigned hdrCols;
+
+  const char* bodyBegin;
+  std::vector<chunk> chunks;
+
+  // Skips the comments in the beginning of the file. Marks if the
+  // file has a %%Header (header must come after '%%').
+  void ignoreComments() noexcept(false);
+  void readHeader() noexcept(false);
+  void splitChunks();
+
+  // Parse passes. Each one goes over all the chunks in parallel.
+  unsigned scanMaxNodeId() noexcept(false);
+  unsigned countEdges(std::vector<unsigned>& numEdges) noexcept(false);
+  weightT placeEdges(graphT& graph, std::vector<unsigned>& numEdges)
+    noexcept(false);
+};
+
+}
+
+#endif
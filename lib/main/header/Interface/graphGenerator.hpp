@@ -0,0 +1,119 @@
+//===----------------------------------------------------------===//
+// Interface module
+//
+// File purpose: graphGenerator class header
+//
+// Description: makes synthetic graphs, for inputs larger than the
+// ones in ~benchmarks~. The kinds of graph are:
+//
+// uniform: every edge joins two nodes taken uniformly at random.
+// rmat:    R-MAT (Chakrabarti et al., 2004) with the Graph500
+//          probabilities, which gives the skewed degrees of social
+//          and web graphs. The number of nodes is rounded up to a
+//          power of two, and node IDs are scrambled, so that the
+//          nodes of high degree are not all at the start.
+// grid:    a square 2D grid where every node has an edge to each of
+//          its four neighbours, like a road network. The grid wraps
+//          around at the borders. The number of nodes is rounded down
+//          to a square.
+//
+// Weights are drawn from [1, maxWeight], uniformly, from an
+// exponential distribution with a mean of about maxWeight / 8, or
+// are all maxWeight.
+//
+// Edge ~i~ only depends on the seed and on ~i~, so any range of edges
+// can be made by any thread, and the same seed always gives the same
+// graph, whatever the number of threads.
+//===----------------------------------------------------------===//
+
+#ifndef GRAPH_GENERATOR_H
+#define GRAPH_GENERATOR_H
+
+#include "DS/csrGraph.hpp"
+#include "Utils/defs.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace Interface {
+
+class graphGenerator {
+  using graphT = DS::csrGraph;
+
+public:
+  enum class kind { uniform, rmat, grid };
+  enum class weightDist { uniform, exponential, constant };
+
+  struct params {
+    kind graphKind = kind::uniform;
+    unsigned numNodes = 0x10000;
+    // Average number of outgoing edges. Not used by grids.
+    unsigned degree = 8;
+    weightDist weights = weightDist::uniform;
+    weightT maxWeight = 1000;
+    uint64_t seed = 1;
+  };
+
+  graphGenerator(const params& inParams, const unsigned numThreads)
+    noexcept(false);
+
+  static kind parseKind(const std::string& arg) noexcept(false);
+  static weightDist parseWeightDist(const std::string& arg) noexcept(false);
+  // Inverses of the two functions above
+  static const char* kindName(const kind graphKind);
+  static const char* weightDistName(const weightDist weights);
+
+  // After rounding (see above).
+  unsigned getNumNodes() const;
+  edgeIdT getNumEdges() const;
+
+  // Builds the graph in memory. Ownership of the returned object goes
+  // to the caller.
+  graphT* build() const noexcept(false);
+
+  // Writes the edges as a MatrixMarket edge list, which
+  // ~edgeListReader~ reads back.
+  void writeText(const std::string& outFileName) const noexcept(false);
+
+private:
+  // Graph500 R-MAT probabilities of the top-left, top-right and
+  // bottom-left quadrants. The bottom-right one gets the rest.
+  static constexpr double krmatA = 0.57;
+  static constexpr double krmatB = 0.19;
+  static constexpr double krmatC = 0.19;
+  // Edges made at once by one thread.
+  static constexpr edgeIdT kchunkEdges = 0x10000;
+  // Longest line of the text output: three 32-bit numbers, two
+  // blanks and the line break.
+  static constexpr unsigned kmaxLineLen = 3 * 10 + 3;
+  // Mean of the exponential weights is maxWeight / kexpDivisor.
+  static constexpr double kexpDivisor = 8;
+  // Random streams of an edge. R-MAT takes one per level, from
+  // krmatStream on.
+  static constexpr uint64_t ksrcStream = 0;
+  static constexpr uint64_t kdestStream = 1;
+  static constexpr uint64_t kweightStream = 2;
+  static constexpr uint64_t krmatStream = 3;
+  static constexpr uint64_t knumStreams = 32;
+
+  const params prm;
+  const unsigned numThreads;
+  unsigned numNodes;
+  edgeIdT numEdges;
+  // R-MAT levels, and side of the grid
+  unsigned scale;
+  unsigned side;
+
+  // Makes edge ~edgeId~.
+  void makeEdge(const edgeIdT edgeId, nodeIdT& src, nodeIdT& dest) const;
+  void makeRmatEdge(const edgeIdT edgeId, nodeIdT& src, nodeIdT& dest) const;
+  nodeIdT scramble(const nodeIdT nodeId) const;
+  weightT makeWeight(const edgeIdT edgeId) const;
+  // A 64-bit random number that only depends on the seed, ~edgeId~
+  // and ~stream~.
+  uint64_t random(const edgeIdT edgeId, const uint64_t stream) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,113 @@
+//===----------------------------------------------------------===//
+// Interface module
+//
+// File purpose: graphSnapshot class header
+//
+// Description: binary snapshot of a ~DS::csrGraph~. The file is laid
+// out so that it can be memory mapped and handed to the algorithm as
+// it is, without any parsing or copying:
+//
+// [header]
+// [offsets]  numNodes + 1 edge IDs
+// [targets]  numEdges node IDs
+// [weights]  numEdges weights
+//
+// Every array starts at a multiple of ~kalignment~ bytes. The header
+// records the widths of the element types, so that a snapshot is
+// never read with types other than the ones it was written with.
+//
+// The edges of every node are stored sorted by weight, as the graph
+// expects them to be (see ~DS::csrGraph~).
+//
+// Graphs with packed targets and weights (see ~DS::packedEdges~) are
+// written packed, and are loaded packed too:
+//
+// [header]
+// [offsets]  numNodes + 1 edge IDs
+// [groups]   one per ~DS::packedEdges::kgroupSz~ edges
+// [edges]    edgeBytesSz bytes, the targets and weights of the groups
+//===----------------------------------------------------------===//
+
+#ifndef GRAPH_SNAPSHOT_H
+#define GRAPH_SNAPSHOT_H
+
+#include "DS/csrGraph.hpp"
+#include "Utils/defs.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace Interface {
+
+class graphSnapshot {
+  using graphT = DS::csrGraph;
+
+public:
+  static constexpr uint32_t kversion = 3;
+
+  // Writes ~graph~ to ~outFileName~, overwriting it.
+  static void write(const graphT& graph, const std::string& outFileName)
+    noexcept(false);
+
+  // Maps ~inFileName~ and returns a graph that views it. Only the
+  // header is validated, unless ~verifyChecksum~ is set, in which
+  // case all the arrays are read once to check them. Ownership of the
+  // returned object goes to the caller.
+  static graphT* load(const std::string& inFileName, bool verifyChecksum)
+    noexcept(false);
+
+  // Whether ~fileName~ starts like a snapshot.
+  static bool isSnapshot(const std::string& fileName) noexcept;
+
+private:
+  static constexpr char kmagic[8] = {'D', 'S', 'G', 'R', 'A', 'P', 'H', '\0'};
+  static constexpr uint32_t kbyteOrderMark = 0x01020304;
+  static constexpr uint64_t kalignment = 64;
+
+  struct header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint8_t edgeIdSz;
+    uint8_t nodeIdSz;
+    uint8_t weightSz;
+    uint8_t isPacked;
+    // Bytes per weight, when packed
+    uint8_t weightWidth;
+    uint8_t reserved[3];
+    uint64_t numNodes;
+    uint64_t numEdges;
+    uint64_t maxEdgeWeight;
+    // Bytes of packed edges, padding included
+    uint64_t edgeBytesSz;
+    // Byte positions of the arrays in the file. When packed, the
+    // packed edges are in place of the targets, and the weights are
+    // empty; otherwise the groups are.
+    uint64_t offsetsPos;
+    uint64_t groupsPos;
+    uint64_t targetsPos;
+    uint64_t weightsPos;
+    uint64_t fileSz;
+    // Over all the arrays, in file order
+    uint64_t checksum;
+  };
+
+  static header makeHeader(const graphT& graph);
+  // Fills in the positions of the arrays and the size of the file
+  // out of the rest of the header.
+  static void layOut(header& hdr);
+  static uint64_t groupsSz(const header& hdr);
+  static uint64_t targetsSz(const header& hdr);
+  static uint64_t weightsSz(const header& hdr);
+  static void checkHeader(const header& hdr, const uint64_t fileSz,
+                          const std::string& fileName) noexcept(false);
+
+  static uint64_t alignUp(const uint64_t pos)
+  {
+    return (pos + kalignment - 1) / kalignment * kalignment;
+  }
+};
+
+}
+
+#endif
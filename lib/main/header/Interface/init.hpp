@@ -12,17 +12,23 @@
 #ifndef INIT_H
 #define INIT_H
 
+#include "Alg/deltaSelector.hpp"
 #include "Alg/deltaStepping.hpp"
-#include "DS/digraph.hpp"
+#include "Alg/nodeOrder.hpp"
+#include "DS/csrGraph.hpp"
+#include "Interface/distWriter.hpp"
+#include "Interface/queryBatch.hpp"
 #include "Utils/defs.hpp"
 #include "Utils/time.hpp"
 
 #include <fstream>
+#include <memory>
+#include <vector>
 
 namespace Interface {
 
 class init {
-  using digraph = DS::digraph<nodeIdT>;
+  using graphT = DS::csrGraph;
   
 public:
   init(int argc, char** argv);
@@ -30,30 +36,46 @@ public:
 
 private:
   static constexpr int kminProgArgs = 4;
-  static constexpr int kmaxProgArgs = 5;
+  static constexpr int kmaxProgArgs = 7;
   static constexpr int knumProgArgsWithThreads = 5;
+  static constexpr int knumProgArgsWithQueries = 6;
+  static constexpr int knumProgArgsWithGroups = 7;
   static constexpr unsigned kmaxFileNameLen = 0x100;
   static constexpr unsigned kmaxModeLen = 0x100;
   static constexpr float kminDelta = 1;
   static constexpr float kmaxDelta = 1e8f;
   static constexpr int kminNumThreads = 1;
   static constexpr int kmaxNumThreads = 0x100;
-  
-  // Constants for reading graph
-  static constexpr unsigned kmaxNodeId = 0xFFFFFFF;
-  static constexpr int kmaxWeight = 0xFFFFFFF;
+  static constexpr const char* kpathsOption = "--paths";
+  static constexpr const char* koutputOption = "--output=";
+  static constexpr const char* korderOption = "--order=";
+  static constexpr const char* kcompressOption = "--compress";
 
   std::string inFileName;
-  bool inFileHasHeader;
   std::string inMode;
   unsigned numThreads;
   float delta;
+  // Whether ~delta~ is to be chosen from the graph, and how.
+  Alg::deltaSelector::mode deltaMode;
+  // When not empty, the algorithm runs once for each of these, with
+  // the threads split in ~numGroups~.
+  std::vector<queryBatch::query> queries;
+  unsigned numGroups;
+  // Whether to write the shortest paths along with the distances.
+  bool isTrackingPaths;
+  distWriter::format outFormat;
+  // How the nodes are renumbered before running, if at all. Node IDs
+  // given and written out are always the ones of the input file.
+  Alg::nodeOrder::kind orderKind;
+  std::unique_ptr<Alg::nodeOrder> order;
+  // Whether to pack the targets and weights of the graph (see
+  // ~DS::packedEdges~), to fit larger graphs in memory.
+  bool isPacking;
 
   std::string outFileName; // Built with inFileName
-  std::ifstream inFile;
 
   // The graph is built in this class.
-  digraph* inGraph;
+  graphT* inGraph;
 
   // Algorithm timing variable
   std::chrono::duration<double> clkVar;
@@ -62,9 +84,20 @@ private:
   //   the program is safe to run.
   void destroy();
 
-  // Time the run of the algorithm
+  // Time the run of the algorithm, on distances as wide as the graph
+  // needs (see ~Alg::needsWideDists~).
+  void timeRunAlgo();
+  template <typename dsRunT>
   void timeRunAlgo();
+  void timeRunBatch();
+
+  // Chooses ~delta~ when the user asked for it to be automatic.
+  void selectDelta(const nodeIdT sourceNode);
   
+  // Takes the options out of ~argv~, and returns the number of
+  // arguments left.
+  int takeOptions(int argc, char** argv) noexcept(false);
+
   // Performs some basic validation on the program arguments.
   bool validateArguments(int argc, char** argv) const noexcept;
 
@@ -72,22 +105,26 @@ private:
   // to ensure its validity.
   void processEntries(int argc, char** argv) noexcept(false);
 
-  void openInFile(char const* fileArgName, const char* inModeArg);
+  void assignInFile(char const* fileArgName, const char* inModeArg);
   
   // Reads in the edges of the graph. Aux for ~processEntries~.
   void readEdges() noexcept(false);
-  // Ignores comments that can come in the beggining of a file.
-  void ignoreComments() noexcept(false);
+
+  // Replaces the graph with its nodes renumbered by ~orderKind~.
+  void reorder() noexcept(false);
   
   // This functions prints the graph. It is used just for debug
   // output.
   void printInGraph() noexcept(false);
 
   // Writes the output distances relation to the outputFile
-  void writeOut(Alg::deltaStepping&);
-  void printOut(Alg::deltaStepping& dsRun) const;
+  template <typename dsRunT>
+  void writeOut(dsRunT& dsRun);
+  template <typename dsRunT>
+  void printOut(dsRunT& dsRun) const;
   void printGraphSize() const;
-  void printOutDists(Alg::deltaStepping& dsRun) const;
+  template <typename dsRunT>
+  void printOutDists(dsRunT& dsRun) const;
   void printOutTime() const noexcept;
   
 };
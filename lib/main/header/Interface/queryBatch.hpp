@@ -0,0 +1,93 @@
+//===----------------------------------------------------------===//
+// Interface module
+//
+// File purpose: queryBatch class header
+//
+// Description: runs the algorithm from many source nodes over one
+// loaded graph. The threads are split into groups, and each group
+// takes the next source as soon as it is done with the previous one.
+// Every group keeps a single ~Alg::deltaStepping~ for all of its
+// queries, so the distances and buckets are allocated only once per
+// group, and each query only resets the nodes the previous one
+// reached.
+//
+// A query may also have a target node, and then only the distance
+// to it is computed.
+//
+// Distances are written as they are found, each query as a block
+// that starts with the comment line "% source <node>" (followed by
+// "target <node>", if any). In the binary format, each query is a
+// record of its own instead (see ~distWriter~). With more than one
+// group, the blocks are not in the order of the queries.
+//===----------------------------------------------------------===//
+
+#ifndef QUERY_BATCH_H
+#define QUERY_BATCH_H
+
+#include "Alg/deltaStepping.hpp"
+#include "DS/csrGraph.hpp"
+#include "Interface/distWriter.hpp"
+#include "Utils/defs.hpp"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Interface {
+
+class queryBatch {
+  using graphT = DS::csrGraph;
+
+public:
+  struct query {
+    nodeIdT source;
+    nodeIdT target; // Alg::deltaStepping::knoTarget if none
+  };
+
+  // ~numThreads~ are split evenly between ~numGroups~.
+  queryBatch(graphT* graph, const std::string& mode, const float delta,
+             const unsigned numThreads, const unsigned numGroups,
+             const bool isTrackingPaths = false,
+             const distWriter::format outFormat = distWriter::format::text)
+    noexcept(false);
+
+  // Reads the queries from ~arg~. It is either the name of a file
+  // with the queries separated by blanks, or the queries separated by
+  // commas. A query is a source node, or a source and a target node
+  // joined by a colon, like "0:42". Nodes are numbered as in the
+  // output, from 0.
+  static std::vector<query> readQueries(const char* arg) noexcept(false);
+
+  // Queries and distances keep the node IDs ~order~ was computed
+  // from, when ~graph~ is reordered (see ~Alg::nodeOrder~).
+  void setNodeOrder(const Alg::nodeOrder* order);
+
+  void run(const std::vector<query>& queries, std::ostream& os)
+    noexcept(false);
+
+private:
+  graphT* graph;
+  const std::string mode;
+  const float delta;
+  const unsigned numGroups;
+  const unsigned threadsPerGroup;
+  const bool isTrackingPaths;
+  const Alg::nodeOrder* order;
+  distWriter writer;
+
+  static void parseQueries(std::istream& is, const char sep,
+                           std::vector<query>& queries) noexcept(false);
+  static nodeIdT parseNode(const std::string& token) noexcept(false);
+  // ~run~, on distances as wide as the graph needs (see
+  // ~Alg::needsWideDists~).
+  template <typename dsRunT>
+  void runGroups(const std::vector<query>& queries, std::ostream& os)
+    noexcept(false);
+  template <typename dsRunT>
+  void writeQuery(const query& q, dsRunT& dsRun, std::ostream& os)
+    noexcept(false);
+};
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+//===----------------------------------------------------------===//
+// Utils module
+//
+// File purpose: declaration of class ~atomicOps~. This class wraps
+// the atomic read-modify-write operations used on plain arrays that
+// are shared between threads, such as the tentative distances.
+//
+// Description: the GCC ~__atomic~ builtins act on ordinary objects,
+// which lets the arrays keep being ~std::vector~s of plain values.
+// Everything is relaxed by default: the algorithm only needs each
+// single update to be atomic, and the phase barriers order everything
+// else. ~fetchAdd~, ~exchange~ and ~store~ may be given a stronger
+// order, for the few places where one thread has to see what the
+// others did without a barrier in between, such as spin locks.
+//===----------------------------------------------------------===//
+
+#ifndef ATOMIC_OPS_H
+#define ATOMIC_OPS_H
+
+namespace Utils {
+
+template <typename valueType>
+class atomicOps {
+public:
+  static inline valueType load(const valueType* addr)
+  {
+    return __atomic_load_n(addr, __ATOMIC_RELAXED);
+  }
+
+  static inline void store(valueType* addr, const valueType val,
+                           const int order = __ATOMIC_RELAXED)
+  {
+    __atomic_store_n(addr, val, order);
+  }
+
+  // Adds ~val~ to ~*addr~, and returns the value it had before.
+  static inline valueType fetchAdd(valueType* addr, const valueType val,
+                                   const int order = __ATOMIC_RELAXED)
+  {
+    return __atomic_fetch_add(addr, val, order);
+  }
+
+  // Replaces ~*addr~ with ~val~, and returns the value it had before.
+  static inline valueType exchange(valueType* addr, const valueType val,
+                                   const int order = __ATOMIC_RELAXED)
+  {
+    return __atomic_exchange_n(addr, val, order);
+  }
+
+  // Sets the bits of ~val~ in ~*addr~, and returns the value it had
+  // before.
+  static inline valueType fetchOr(valueType* addr, const valueType val)
+  {
+    return __atomic_fetch_or(addr, val, __ATOMIC_RELAXED);
+  }
+
+  // Replaces ~*addr~ with ~desired~ if it still holds ~expected~.
+  // On failure, ~expected~ gets the value found.
+  static inline bool compareExchange(valueType* addr, valueType& expected,
+                                     const valueType desired)
+  {
+    return __atomic_compare_exchange_n(addr, &expected, desired, false,
+                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+  }
+
+  // Lowers ~*addr~ to ~val~ if ~val~ is smaller. Returns true only
+  // if this call is the one that lowered it, so that exactly one of
+  // the threads racing on ~*addr~ with the winning value sees true.
+  static inline bool fetchMin(valueType* addr, const valueType val)
+  {
+    valueType prev;
+    return fetchMin(addr, val, prev);
+  }
+
+  // The same, and ~prev~ gets the value that was lowered.
+  static inline bool fetchMin(valueType* addr, const valueType val,
+                              valueType& prev)
+  {
+    prev = __atomic_load_n(addr, __ATOMIC_RELAXED);
+    while (val < prev) {
+      // On failure, ~prev~ is refreshed with the value that won.
+      if (__atomic_compare_exchange_n(addr, &prev, val, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+}
+
+#endif
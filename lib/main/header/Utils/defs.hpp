@@ -7,23 +7,50 @@
 #ifndef DEFS_H
 #define DEFS_H
 
+#include <cstdint>
+
 #define MEASURE_TIME // Activate time measuring
 
 // Types used in the algorithm
 typedef unsigned nodeIdT;
 typedef unsigned weightT;
+typedef uint64_t edgeIdT;
 
 // Put here any debugging control macros
 #define ALG_DELTASTEPPING_ASSERT 0
 #define ALG_DELTASTEPPING_DEBUG 0
-
-#define DS_DIGRAPH_DEBUG 0
+// Counts buckets, phases, relaxations and time spent in barriers and
+// merges (see Alg/runStats.hpp). May also be set from the command
+// line, with -DALG_DELTASTEPPING_STATS=1.
+#ifndef ALG_DELTASTEPPING_STATS
+#define ALG_DELTASTEPPING_STATS 0
+#endif
+// Filters the edges of nodes of high degree with AVX2 or AVX-512,
+// when the CPU has them (see Alg/relaxKernel.hpp). May also be set
+// from the command line, with -DALG_DELTASTEPPING_SIMD=0.
+#ifndef ALG_DELTASTEPPING_SIMD
+#define ALG_DELTASTEPPING_SIMD 1
+#endif
+// Starts every thread with the frontier nodes of its own part of the
+// graph, on machines with more than one NUMA node (see
+// Alg/frontierScheduler.hpp). May also be set from the command line,
+// with -DALG_DELTASTEPPING_NUMA=0.
+#ifndef ALG_DELTASTEPPING_NUMA
+#define ALG_DELTASTEPPING_NUMA 1
+#endif
+
+#define DS_CSRGRAPH_DEBUG 0
 
 #define INTERFACE_INIT_DEBUG 0
 #define INTERFACE_INIT_PRINT_GRAPH 0
 #define INTERFACE_INIT_PRINT_GRAPH_SIZE 0
 #define INTERFACE_INIT_PRINT_DISTS 0
 #define INTERFACE_INIT_PRINT_TIME 1
+// Reports the delta that was chosen, when it is automatic.
+#define INTERFACE_INIT_PRINT_DELTA 1
+// Reads the whole of a snapshot input once to check its checksum.
+// Off by default, as it defeats loading snapshots in constant time.
+#define INTERFACE_INIT_VERIFY_SNAPSHOT 0
 
 
 #endif // #ifndef DEFS_H
@@ -0,0 +1,47 @@
+//===----------------------------------------------------------===//
+// Utils module
+//
+// File purpose: declaration of class ~mappedFile~.
+//
+// Description: a read-only memory mapping of a whole file. The
+// mapping lives as long as the object, so pointers obtained from
+// ~data~ must not outlive it.
+//===----------------------------------------------------------===//
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace Utils {
+
+class mappedFile {
+public:
+  explicit mappedFile(const std::string& fileName) noexcept(false);
+  ~mappedFile();
+
+  mappedFile(const mappedFile&) = delete;
+  mappedFile& operator =(const mappedFile&) = delete;
+
+  const char* data() const
+  {
+    return begin;
+  }
+
+  std::size_t size() const
+  {
+    return sz;
+  }
+
+  // Hints the kernel that the mapping will be read front to back.
+  void adviseSequential() const noexcept;
+
+private:
+  const char* begin;
+  std::size_t sz;
+};
+
+}
+
+#endif
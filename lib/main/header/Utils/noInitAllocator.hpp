@@ -0,0 +1,55 @@
+//===----------------------------------------------------------===//
+// Utils module
+//
+// File purpose: declaration of class ~noInitAllocator~.
+//
+// Description: an allocator that leaves the elements that a
+// container default constructs uninitialized, when they are of a
+// trivial type. Growing a vector with ~resize~ then costs nothing
+// more than the allocation, which is what we want when every new
+// element is going to be written over right away.
+//===----------------------------------------------------------===//
+
+#ifndef NO_INIT_ALLOCATOR_H
+#define NO_INIT_ALLOCATOR_H
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Utils {
+
+template <typename valueType,
+          typename baseAllocT = std::allocator<valueType> >
+class noInitAllocator : public baseAllocT {
+  using traitsT = std::allocator_traits<baseAllocT>;
+
+public:
+  template <typename otherT>
+  struct rebind {
+    using other =
+      noInitAllocator<otherT,
+                      typename traitsT::template rebind_alloc<otherT> >;
+  };
+
+  using baseAllocT::baseAllocT;
+
+  template <typename otherT>
+  void construct(otherT* ptr)
+    noexcept(std::is_nothrow_default_constructible<otherT>::value)
+  {
+    ::new (static_cast<void*>(ptr)) otherT;
+  }
+
+  template <typename otherT, typename... argsT>
+  void construct(otherT* ptr, argsT&&... args)
+  {
+    traitsT::construct(static_cast<baseAllocT&>(*this), ptr,
+                       std::forward<argsT>(args)...);
+  }
+};
+
+}
+
+#endif
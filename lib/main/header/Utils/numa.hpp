@@ -0,0 +1,24 @@
+//===----------------------------------------------------------===//
+// Utils module
+//
+// File purpose: declaration of class ~numa~. This file contains
+// what the program needs to know about the NUMA nodes of the
+// machine it runs on.
+//===----------------------------------------------------------===//
+
+#ifndef NUMA_H
+#define NUMA_H
+
+namespace Utils {
+
+class numa {
+public:
+  // Number of NUMA nodes that are online, as listed by Linux in
+  // /sys/devices/system/node/online. 1 if it cannot be read, as on
+  // other systems.
+  static unsigned numNodes();
+};
+
+}
+
+#endif
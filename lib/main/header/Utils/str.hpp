@@ -24,6 +24,25 @@ public:
   // Gets the basename of the name, and adds the suffix ~outSuffix~.
   static std::string getOutName(std::string& inName);
 
+  // Writes the decimal digits of ~val~ at ~p~, and returns the
+  // position right after them (at most 20 characters on). Meant for
+  // writing many numbers fast, without a stream.
+  static inline char* appendUns(char* p, uint64_t val)
+  {
+    // Digits are made from the last one, into a scratch buffer, so
+    // that there is a single pass over the number.
+    char digits[20];
+    unsigned len = 0;
+    do {
+      digits[len++] = static_cast<char>('0' + val % 10);
+      val /= 10;
+    } while (val != 0);
+    while (len != 0) {
+      *p++ = digits[--len];
+    }
+    return p;
+  }
+
 private:
   static uint64_t constexpr mix(const char, uint64_t s);
 
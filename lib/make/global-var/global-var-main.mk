@@ -14,3 +14,8 @@ BUILD_MAIN :=
 
 MAIN_FILE = tools/main.cpp
 TARGET = $(BUILD)/delta-stepping
+
+# Auxiliary tools. Each $(TOOL_DIR)/<tool>.cpp is linked against the same
+#   objects as the main target, into $(BUILD)/<tool>.
+TOOL_DIR = tools
+TOOLS = convert generate bench
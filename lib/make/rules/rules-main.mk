@@ -5,12 +5,21 @@
 #   target.
 # ------------------------------------------------------------------------------
 
-# Links objects. Put first to avoid errors with .DEFAULT_GOAL assignment.
+# Builds the main target and the tools. Put first to avoid errors with
+#   .DEFAULT_GOAL assignment.
+all : $(TARGET) $(TOOL_TARGETS)
+
+# Links objects.
 $(TARGET) : $(TARGET_DEPENDENCIES)
 	$(info Linking main...)
 	@$(LINK_CODE)
 	$(info Done.)
 
+# Links each tool.
+$(TOOL_TARGETS) : $(BUILD)/% : $(TOOL_DIR)/%.cpp $(TARGET_DEPENDENCIES)
+	$(info Linking $*...)
+	@$(TOOL_LINK_CODE)
+
 # Compiles objects.
 $(BUILD_MAIN)/%$(OBJECT_EXTENSION) :: $(APPLIANCE_MAIN)/%$(APP_EXTENSION) $(HEADER_MAIN)/%$(HEADER_EXTENSION)
 	$(info $@)
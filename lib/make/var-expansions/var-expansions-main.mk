@@ -21,4 +21,8 @@ LINK_CODE = $(CXX) $(FLAGS) -I $(HEADER_MAIN) $(OBJECT_MAIN_FILES) $(MAIN_FILE)
 
 BUILD_MODS_MAIN := $(patsubst %, $(BUILD_MAIN)/%, $(MODULES))
 
+# Auxiliary tools executables, and their linking code
+TOOL_TARGETS := $(patsubst %, $(BUILD)/%, $(TOOLS))
+TOOL_LINK_CODE = $(CXX) $(FLAGS) -I $(HEADER_MAIN) $(OBJECT_MAIN_FILES) $< -o $@
+
 TARGET_DEPENDENCIES := $(MAIN_FILE) $(HEADER_MAIN_FILES) $(APPLIANCE_MAIN_FILES) $(BUILD_MODS_MAIN) $(OBJECT_MAIN_FILES)
@@ -0,0 +1,143 @@
+//===----------------------------------------------------------===//
+// File purpose: main function of the bench tool.
+//
+// Description: runs a sweep of modes, deltas and thread counts over
+// some graphs (see ~Interface::benchmark~), and writes the timings of
+// every phase as CSV or JSON.
+//===----------------------------------------------------------===//
+
+
+#include "Interface/benchmark.hpp"
+
+#include <cerrno>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const char* const kusage =
+  "Usage: <program> <graph>[,<graph>...] [<key>=<value> ...]\n"
+  "  modes=<m>,...    (default dijkstra,parallel,parallel-bucket-fusion)\n"
+  "  deltas=<d>,...   numbers, 'auto' or 'auto-refine' (default auto)\n"
+  "  threads=<t>,...  (default 1)\n"
+  "  reps=<n>         timed repetitions (default 5)\n"
+  "  warmup=<n>       repetitions before them (default 1)\n"
+  "  source=<s>       (default 0)\n"
+  "  target=<t>       (default none)\n"
+  "  output=<f>       text | binary | none (default text)\n"
+  "  out-file=<f>     where distances go (default /dev/null)\n"
+  "  format=<f>       csv | json (default csv)\n"
+  "  report=<f>       where the report goes (default stdout)\n";
+
+vector<string> splitList(const string& val)
+{
+  vector<string> items;
+  istringstream iss(val);
+  string item;
+  while (getline(iss, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+template <typename numType>
+numType parseNum(const string& key, const string& val) noexcept(false)
+{
+  std::stringstream ss;
+  ss << val;
+  numType n = 0;
+  ss >> n;
+  if (val.empty() || val[0] == '-' || ss.fail() || !ss.eof()) {
+    throw std::invalid_argument{string("Invalid ") + key + " '" + val + "'"};
+  }
+  return n;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2) {
+    cerr << kusage;
+    return EINVAL;
+  }
+
+  try {
+    Interface::benchmark::sweep swp;
+    swp.graphs = splitList(argv[1]);
+    Interface::benchmark::format reportFormat =
+      Interface::benchmark::format::csv;
+    string reportFileName;
+    for (int i = 2; i < argc; ++i) {
+      const string arg = argv[i];
+      const size_t eqPos = arg.find('=');
+      const string key = arg.substr(0, eqPos);
+      const string val = eqPos == string::npos ? "" : arg.substr(eqPos + 1);
+      if (key == "modes") {
+        swp.modes = splitList(val);
+      }
+      else if (key == "deltas") {
+        swp.deltas = splitList(val);
+      }
+      else if (key == "threads") {
+        swp.threads.clear();
+        for (const string& item : splitList(val)) {
+          swp.threads.push_back(parseNum<unsigned>(key, item));
+        }
+      }
+      else if (key == "reps") {
+        swp.numReps = parseNum<unsigned>(key, val);
+      }
+      else if (key == "warmup") {
+        swp.numWarmups = parseNum<unsigned>(key, val);
+      }
+      else if (key == "source") {
+        swp.sourceNode = parseNum<nodeIdT>(key, val);
+      }
+      else if (key == "target") {
+        swp.targetNode = parseNum<nodeIdT>(key, val);
+      }
+      else if (key == "output") {
+        swp.outFormat = Interface::distWriter::parseFormat(val);
+      }
+      else if (key == "out-file") {
+        swp.outFileName = val;
+      }
+      else if (key == "format") {
+        reportFormat = Interface::benchmark::parseFormat(val);
+      }
+      else if (key == "report") {
+        reportFileName = val;
+      }
+      else {
+        cerr << kusage;
+        return EINVAL;
+      }
+    }
+
+    Interface::benchmark bench(swp);
+    if (reportFileName.empty()) {
+      bench.run(cout, reportFormat);
+    }
+    else {
+      ofstream ofs(reportFileName);
+      bench.run(ofs, reportFormat);
+    }
+  }
+  catch (std::exception& e) {
+    cerr << "Uncaught exception:\n"\
+      "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n"\
+         << e.what() << "\n"\
+      "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n";
+    return errno ? errno : 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+//===----------------------------------------------------------===//
+// File purpose: main function of the convert tool.
+//
+// Description: parses a text edge list (the same formats accepted by
+// delta-stepping) and writes it as a binary graph snapshot. The
+// snapshot can then be given to delta-stepping in place of the text
+// file, and is loaded without any parsing. With --compress, the
+// targets and weights are written packed (see DS/packedEdges.hpp);
+// the input may then be a snapshot too.
+//===----------------------------------------------------------===//
+
+
+#include "Interface/edgeListReader.hpp"
+#include "Interface/graphSnapshot.hpp"
+
+#include <cerrno>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char** argv)
+{
+  bool isPacking = false;
+  if (argc > 1 && string(argv[argc - 1]) == "--compress") {
+    isPacking = true;
+    --argc;
+  }
+  if (argc != 3 && argc != 4) {
+    cerr << "Usage: <program> <in-file> <out-file> [<num-threads>]"\
+      " [--compress]\n";
+    return EINVAL;
+  }
+
+  try {
+    unsigned numThreads = 1;
+    if (argc == 4) {
+      std::stringstream ss;
+      ss << argv[3];
+      ss >> numThreads;
+      if (numThreads < 1) {
+        throw std::invalid_argument{string("Invalid number of threads '") +
+                                      argv[3] + "'"};
+      }
+    }
+
+    unique_ptr<DS::csrGraph> graph;
+    if (Interface::graphSnapshot::isSnapshot(argv[1])) {
+      graph.reset(Interface::graphSnapshot::load(argv[1], false));
+    }
+    else {
+      Interface::edgeListReader reader(argv[1], numThreads);
+      graph.reset(reader.read());
+    }
+    if (isPacking) {
+      graph->pack(numThreads);
+    }
+    Interface::graphSnapshot::write(*graph, argv[2]);
+    cout << graph->getNumNodes() << " nodes, " << graph->getNumEdges()
+         << " edges\n";
+  }
+  catch (std::exception& e) {
+    cerr << "Uncaught exception:\n"\
+      "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n"\
+         << e.what() << "\n"\
+      "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n";
+    return errno ? errno : 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,122 @@
+//===----------------------------------------------------------===//
+// File purpose: main function of the generate tool.
+//
+// Description: makes a synthetic graph (see
+// ~Interface::graphGenerator~) and writes it either as a text edge
+// list or as a binary graph snapshot, both of which delta-stepping
+// takes as input. The same arguments always give the same graph.
+//===----------------------------------------------------------===//
+
+
+#include "Interface/graphGenerator.hpp"
+#include "Interface/graphSnapshot.hpp"
+
+#include <cerrno>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+const char* const kusage =
+  "Usage: <program> <kind> <out-file> [<key>=<value> ...]\n"
+  "  <kind>       uniform | rmat | grid\n"
+  "  nodes=<n>    number of nodes (default 65536)\n"
+  "  degree=<d>   average out-degree, not used by grids (default 8)\n"
+  "  weights=<w>  uniform | exponential | constant (default uniform)\n"
+  "  max-weight=<w>  largest edge weight (default 1000)\n"
+  "  seed=<s>     (default 1)\n"
+  "  format=<f>   text | binary (default text)\n"
+  "  threads=<t>  (default 1)\n";
+
+template <typename numType>
+numType parseNum(const string& key, const string& val) noexcept(false)
+{
+  std::stringstream ss;
+  ss << val;
+  numType n = 0;
+  ss >> n;
+  if (val.empty() || val[0] == '-' || ss.fail() || !ss.eof()) {
+    throw std::invalid_argument{string("Invalid ") + key + " '" + val + "'"};
+  }
+  return n;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 3) {
+    cerr << kusage;
+    return EINVAL;
+  }
+
+  try {
+    Interface::graphGenerator::params prm;
+    prm.graphKind = Interface::graphGenerator::parseKind(argv[1]);
+    const string outFileName = argv[2];
+    bool isBinary = false;
+    unsigned numThreads = 1;
+    for (int i = 3; i < argc; ++i) {
+      const string arg = argv[i];
+      const size_t eqPos = arg.find('=');
+      const string key = arg.substr(0, eqPos);
+      const string val = eqPos == string::npos ? "" : arg.substr(eqPos + 1);
+      if (key == "nodes") {
+        prm.numNodes = parseNum<unsigned>(key, val);
+      }
+      else if (key == "degree") {
+        prm.degree = parseNum<unsigned>(key, val);
+      }
+      else if (key == "weights") {
+        prm.weights = Interface::graphGenerator::parseWeightDist(val);
+      }
+      else if (key == "max-weight") {
+        prm.maxWeight = parseNum<weightT>(key, val);
+      }
+      else if (key == "seed") {
+        prm.seed = parseNum<uint64_t>(key, val);
+      }
+      else if (key == "format") {
+        if (val != "text" && val != "binary") {
+          throw std::invalid_argument{string("Unknown format '") + val + "'"};
+        }
+        isBinary = val == "binary";
+      }
+      else if (key == "threads") {
+        numThreads = parseNum<unsigned>(key, val);
+        if (numThreads < 1) {
+          throw std::invalid_argument{string("Invalid number of threads '") +
+                                        val + "'"};
+        }
+      }
+      else {
+        cerr << kusage;
+        return EINVAL;
+      }
+    }
+
+    Interface::graphGenerator generator(prm, numThreads);
+    if (isBinary) {
+      unique_ptr<DS::csrGraph> graph{generator.build()};
+      Interface::graphSnapshot::write(*graph, outFileName);
+    }
+    else {
+      generator.writeText(outFileName);
+    }
+    cout << generator.getNumNodes() << " nodes, " << generator.getNumEdges()
+         << " edges\n";
+  }
+  catch (std::exception& e) {
+    cerr << "Uncaught exception:\n"\
+      "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n"\
+         << e.what() << "\n"\
+      "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n";
+    return errno ? errno : 1;
+  }
+
+  return 0;
+}